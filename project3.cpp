@@ -7,13 +7,91 @@
 #include <cmath>
 #include <algorithm>
 #include <map>
+#include <queue>
+#include <unordered_map>
+#include <climits>
+#include <cstdint>
+#include <type_traits>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+#include <fstream>
+#include <memory>
+#include <new>
 #include <unistd.h> 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
 using namespace std;
 
 // κανω declare απο πριν τις κλάσεις που θα χρειαστω
 class GridWorld;
 class Object;
 
+//κατηγοριες και επιπεδα μηνυματων του logger
+enum class LogCat : unsigned char { Lifecycle, Sensors, Fusion, Decisions, Render, Collisions };
+enum class LogLevel : unsigned char { Error, Warn, Info, Debug };
+
+//απλος logger με επιπεδα και διακοπτη ανα κατηγορια. γραφει στο cout χωρις flush σε καθε γραμμη
+class Logger {
+public:
+    static LogLevel level;
+    static unsigned categories;   // ενα bit για καθε LogCat
+
+    static bool enabled(LogCat cat, LogLevel lvl) {
+        return lvl <= level && (categories & (1u << (int)cat));
+    }
+
+    static ostream& out() { return cout; }
+
+    static bool parseLevel(const string& name) {
+        static const char* names[] = {"error", "warn", "info", "debug"};
+        for (int i = 0; i < 4; i++) {
+            if (name == names[i]) {
+                level = (LogLevel)i;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // λιστα κατηγοριων χωρισμενη με κομμα, π.χ. "lifecycle,decisions", ή "all" / "none"
+    static bool parseCategories(const string& list) {
+        static const char* names[] = {"lifecycle", "sensors", "fusion", "decisions", "render", "collisions"};
+        unsigned mask = 0;
+        size_t start = 0;
+        while (start <= list.size()) {
+            size_t end = list.find(',', start);
+            if (end == string::npos) end = list.size();
+            string name = list.substr(start, end - start);
+            if (name == "all") mask = ~0u;
+            else if (name != "none" && !name.empty()) {
+                int found = -1;
+                for (int i = 0; i < 6; i++) if (name == names[i]) found = i;
+                if (found < 0) return false;
+                mask |= 1u << found;
+            }
+            start = end + 1;
+        }
+        categories = mask;
+        return true;
+    }
+};
+
+LogLevel Logger::level = LogLevel::Debug;
+unsigned Logger::categories = ~0u;
+
+// αν η κατηγορια ή το επιπεδο ειναι κλειστα δεν εκτελειται τιποτα απο την εκφραση του μηνυματος
+#define LOG(cat, lvl) if (!Logger::enabled(LogCat::cat, LogLevel::lvl)) {} else Logger::out()
+
 //struct για την θεση αντικειμενων στον κοσμο
 struct Position {
     int x;                                  
@@ -34,37 +112,587 @@ struct Position {
     }
 };
 
+// κωδικοι για το ειδος, την κατευθυνση και την κατασταση φαναριου ωστε να χωρανε σε πινακες
+enum class Kind : unsigned char { Bike, Car, ParkedCar, StopSign, TrafficLight, SelfDrivingCar };
+enum class Dir : unsigned char { None, N, S, E, W };
+enum class Light : unsigned char { None, Red, Green, Yellow };
+
+const char* kindName(Kind k) {
+    static const char* names[] = {"Bike", "Car", "ParkedCar", "StopSign", "TrafficLight", "SelfDrivingCar"};
+    return names[(int)k];
+}
+
+const char* dirName(Dir d) {
+    static const char* names[] = {"", "N", "S", "E", "W"};
+    return names[(int)d];
+}
+
+const char* lightName(Light l) {
+    static const char* names[] = {"", "RED", "GREEN", "YELLOW"};
+    return names[(int)l];
+}
+
+char lightGlyph(Light l) {
+    static const char glyphs[] = {'?', 'R', 'G', 'Y'};
+    return glyphs[(int)l];
+}
+
+// ο κυκλος φαναριου: κοκκινο -> 4 ticks - πρασινο -> 8 ticks - κιτρινο -> 2 ticks
+const int LIGHT_CYCLE = 14;
+
+// η κατασταση του φαναριου μετα απο clock ticks, αν ξεκινησε απο τη θεση phase του κυκλου. ειναι κλειστος
+// τυπος, ετσι τα φαναρια δεν χρειαζονται ενημερωση σε καθε tick, υπολογιζονται μονο οταν τα κοιταξει κανεις
+inline Light lightAt(int phase, int clock) {
+    int p = (phase + clock) % LIGHT_CYCLE;
+    return p < 4 ? Light::Red : (p < 12 ? Light::Green : Light::Yellow);
+}
+
+// ακεραιο handle ταυτοτητας: το ειδος στα 8 πανω bits και ο αυξων αριθμος στα υπολοιπα 24
+// ετσι οι αναγνωσεις συγκρινουν ακεραιους και το "Bike:3" φτιαχνεται μονο στην εκτυπωση
+typedef uint32_t Handle;
+
+inline Handle makeHandle(Kind k, int num) { return ((Handle)k << 24) | ((Handle)num & 0xFFFFFF); }
+inline Kind handleKind(Handle h) { return (Kind)(h >> 24); }
+inline int handleNum(Handle h) { return (int)(h & 0xFFFFFF); }
+
 //struct για την ταυτοτητα των αντικειμενων
 struct ID {
-    string type;
+    Kind kind;
     int num;
     
+    Handle handle() const { return makeHandle(kind, num); }
+
     string toString() const {
-        return type + ":" + to_string(num);
+        return string(kindName(kind)) + ":" + to_string(num);
     }
 };
-//struct για την αποθηκευση των αναγνωσεων των αισθητηρων
+//struct για την αποθηκευση των αναγνωσεων των αισθητηρων, χωρις strings ωστε να αντιγραφεται με memcpy
+//και να μη δεσμευει μνημη (24 bytes), τα ονοματα βγαινουν μονο στην print()
 struct SensorReading {
-    string objectType;
     Position position;
-    string objectId;
-    double confidence;
+    Handle objectId;
+    float confidence;
     int distance;
-    int speed;
-    string direction;
-    string signText;
-    string trafficLight;
+    unsigned char speed;
+    Kind objectType;
+    Dir direction;
+    Light trafficLight;
     
-    SensorReading() : confidence(0.0), distance(0), speed(0) {}
+    SensorReading() : objectId(0), confidence(0.0f), distance(0), speed(0),
+                      objectType(Kind::Bike), direction(Dir::None), trafficLight(Light::None) {}
     
+    bool hasSign() const { return objectType == Kind::StopSign; }
+
     void print() const {
-        cout << "  Object: " << objectId << " at (" << position.x << "," << position.y 
-             << "), type: " << objectType << ", distance: " << distance 
-             << ", confidence: " << confidence;
-        if (!trafficLight.empty() && trafficLight != "N/A") cout << ", light: " << trafficLight;
-        if (!signText.empty()) cout << ", sign: " << signText;
-        if (speed > 0) cout << ", speed: " << speed << ", dir: " << direction;
-        cout << endl;
+        ostream& out = Logger::out();
+        out << "  Object: " << kindName(handleKind(objectId)) << ":" << handleNum(objectId)
+            << " at (" << position.x << "," << position.y 
+            << "), type: " << kindName(objectType) << ", distance: " << distance 
+            << ", confidence: " << confidence;
+        if (trafficLight != Light::None) out << ", light: " << lightName(trafficLight);
+        if (hasSign()) out << ", sign: STOP";
+        if (speed > 0) out << ", speed: " << (int)speed << ", dir: " << dirName(direction);
+        out << "\n";
+    }
+};
+
+static_assert(is_trivially_copyable<SensorReading>::value, "SensorReading must stay POD-like");
+
+//γεννητρια τυχαιων αριθμων χωρις κατασταση (counter-based): καθε αριθμος ειναι συναρτηση μονο του
+//(seed, ροη, μετρητης). ετσι καθε οντοτητα, αισθητηρας και tick εχει δικη του ανεξαρτητη ροη, μια
+//παραπανω κληση δεν αλλαζει τις υπολοιπες και το αποτελεσμα δεν εξαρταται απο νηματα ή σειρα υπολογισμου.
+//ολες οι πραξεις ειναι 32-bit πολλαπλασιασμοι και xor, οποτε βροχοι πανω σε πολλους μετρητες γινονται SIMD
+class Rng {
+public:
+    enum Stream : uint32_t { Placement = 1, Direction, LightPhase, SensorNoise };
+
+    static thread_local uint64_t seed;
+
+    static uint32_t hash32(uint32_t x) {
+        x ^= x >> 16;
+        x *= 0x7feb352dU;
+        x ^= x >> 15;
+        x *= 0x846ca68bU;
+        x ^= x >> 16;
+        return x;
+    }
+
+    // κλειδι μιας ροης: ειδος ροης και αναγνωριστικο (handle οντοτητας, αριθμος αισθητηρα, ειδος κλπ)
+    static uint32_t key(Stream stream, uint32_t id) {
+        uint32_t k = hash32((uint32_t)seed ^ hash32((uint32_t)(seed >> 32) + stream * 0x9E3779B9U));
+        return hash32(k ^ hash32(id + 0x632BE5ABU));
+    }
+
+    static uint32_t at(uint32_t key, uint64_t counter) {
+        uint32_t h = hash32((uint32_t)counter ^ key);
+        return hash32(h ^ (uint32_t)(counter >> 32) ^ (key * 0x9E3779B9U));
+    }
+
+    // ομοιομορφα στο [0, n)
+    static int below(uint32_t key, uint64_t counter, int n) {
+        return (int)(((uint64_t)at(key, counter) * (uint32_t)n) >> 32);
+    }
+};
+
+thread_local uint64_t Rng::seed = 0;
+
+//οι φασεις ενος tick που χρονομετρουνται με το --profile
+enum class Phase : unsigned char { Tick, UpdateAll, Movers, Sensors, Fusion, PrintReadings, Movement, Collisions, Render, Count };
+
+const char* phaseName(Phase p) {
+    static const char* names[] = {"tick", "updateAll", "movers", "collectSensorData", "syncNavigationSystem",
+                                  "printReadings", "executeMovement", "collisions", "render"};
+    return names[(int)p];
+}
+
+//καταγραφη του χρονου καθε φασης σε μνημη και εξαγωγη σε Chrome trace (ανοιγει στο chrome://tracing και στο
+//Perfetto) μαζι με p50/p95/p99 ανα φαση. γραφει μονο το νημα της προσομοιωσης, αρα δεν χρειαζεται κλειδωμα
+class Profiler {
+public:
+    struct Event {
+        Phase phase;
+        int tick;
+        long long start;      // ns απο την αρχη της καταγραφης
+        long long duration;   // ns
+    };
+
+    static bool enabled;
+    static int tick;
+
+    static void start() {
+        enabled = true;
+        origin = chrono::steady_clock::now();
+        events.reserve(1 << 16);
+    }
+
+    static long long now() {
+        return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - origin).count();
+    }
+
+    static void record(Phase phase, long long start, long long end) {
+        events.push_back({phase, tick, start, end - start});
+    }
+
+    static bool writeTrace(const string& path) {
+        ofstream file(path);
+        if (!file) return false;
+        file << fixed << setprecision(3);
+        file << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n";
+        file << "  {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 1, \"args\": {\"name\": \"simulation\"}}";
+        for (const Event& e : events) {
+            file << ",\n  {\"name\": \"" << phaseName(e.phase) << "\", \"cat\": \"tick\", \"ph\": \"X\", \"ts\": "
+                 << e.start / 1000.0 << ", \"dur\": " << e.duration / 1000.0
+                 << ", \"pid\": 1, \"tid\": 1, \"args\": {\"tick\": " << e.tick << "}}";
+        }
+        file << "\n], \"phaseSummary\": {";
+        bool first = true;
+        for (int p = 0; p < (int)Phase::Count; p++) {
+            vector<long long> d = durations((Phase)p);
+            if (d.empty()) continue;
+            file << (first ? "\n" : ",\n") << "  \"" << phaseName((Phase)p) << "\": {\"count\": " << d.size()
+                 << ", \"p50_us\": " << percentile(d, 0.50) / 1000.0 << ", \"p95_us\": " << percentile(d, 0.95) / 1000.0
+                 << ", \"p99_us\": " << percentile(d, 0.99) / 1000.0 << "}";
+            first = false;
+        }
+        file << "\n}}\n";
+        return true;
+    }
+
+    static void printSummary(ostream& out) {
+        out << "Profile (" << events.size() << " events):\n";
+        out << "  phase                    count    total ms     p50 us     p95 us     p99 us\n";
+        out << fixed;
+        for (int p = 0; p < (int)Phase::Count; p++) {
+            vector<long long> d = durations((Phase)p);
+            if (d.empty()) continue;
+            long long total = 0;
+            for (long long x : d) total += x;
+            out << "  " << left << setw(22) << phaseName((Phase)p) << right << setw(8) << d.size()
+                << setprecision(2) << setw(12) << total / 1e6 << setprecision(1)
+                << setw(11) << percentile(d, 0.50) / 1000.0 << setw(11) << percentile(d, 0.95) / 1000.0
+                << setw(11) << percentile(d, 0.99) / 1000.0 << "\n";
+        }
+        out.unsetf(ios::fixed);
+        out << setprecision(6);
+    }
+
+private:
+    static chrono::steady_clock::time_point origin;
+    static vector<Event> events;
+
+    // οι διαρκειες μιας φασης ταξινομημενες
+    static vector<long long> durations(Phase phase) {
+        vector<long long> d;
+        for (const Event& e : events) {
+            if (e.phase == phase) d.push_back(e.duration);
+        }
+        sort(d.begin(), d.end());
+        return d;
+    }
+
+    static long long percentile(const vector<long long>& sorted, double p) {
+        return sorted[(size_t)(p * (sorted.size() - 1) + 0.5)];
+    }
+};
+
+bool Profiler::enabled = false;
+int Profiler::tick = 0;
+chrono::steady_clock::time_point Profiler::origin;
+vector<Profiler::Event> Profiler::events;
+
+//χρονομετρει το block που το περιεχει
+class ProfileScope {
+private:
+    Phase phase;
+    long long start;
+public:
+    explicit ProfileScope(Phase p) : phase(p), start(Profiler::enabled ? Profiler::now() : 0) {}
+    ~ProfileScope() {
+        if (Profiler::enabled) Profiler::record(phase, start, Profiler::now());
+    }
+};
+
+#define PROFILE_CONCAT2(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT2(a, b)
+// μονο με -DPROFILER: τοτε καθε scope ελεγχει το Profiler::enabled ακομα και χωρις --profile,
+// χωρις αυτο δεν μενει τιποτα απο τον profiler στα tick
+#ifdef PROFILER
+#define PROFILE_SCOPE(phase) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(Phase::phase)
+#define PROFILE_TICK(t) Profiler::tick = (t)
+#else
+#define PROFILE_SCOPE(phase)
+#define PROFILE_TICK(t)
+#endif
+
+//μικρο thread pool με σταθερα νηματα που ξαναχρησιμοποιουνται απο tick σε tick.
+//η run(count, f) τρεχει τις f(0)..f(count-1) στα νηματα (και στο νημα που την καλει) και περιμενει να τελειωσουν
+class ThreadPool {
+private:
+    vector<thread> workers;
+    mutex lock;
+    condition_variable wake;
+    condition_variable finished;
+    const function<void(int)>* job;
+    int jobCount;
+    atomic<int> nextIndex;
+    int active;
+    unsigned generation;
+    bool stopping;
+
+    void work() {
+        for (int i = nextIndex.fetch_add(1); i < jobCount; i = nextIndex.fetch_add(1)) {
+            (*job)(i);
+        }
+    }
+
+    void workerLoop() {
+        unsigned seen = 0;
+        while (true) {
+            {
+                unique_lock<mutex> guard(lock);
+                wake.wait(guard, [&] { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+            }
+            work();
+            {
+                lock_guard<mutex> guard(lock);
+                if (--active == 0) finished.notify_all();
+            }
+        }
+    }
+
+public:
+    // threads: συνολικα νηματα μαζι με αυτο που καλει την run, αρα δημιουργουνται threads - 1
+    explicit ThreadPool(int threads)
+        : job(nullptr), jobCount(0), nextIndex(0), active(0), generation(0), stopping(false) {
+        for (int i = 1; i < threads; i++) {
+            workers.emplace_back([this] { workerLoop(); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            lock_guard<mutex> guard(lock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& worker : workers) worker.join();
+    }
+
+    int size() const { return (int)workers.size() + 1; }
+
+    void run(int count, const function<void(int)>& f) {
+        if (workers.empty() || count <= 1) {
+            for (int i = 0; i < count; i++) f(i);
+            return;
+        }
+        {
+            lock_guard<mutex> guard(lock);
+            job = &f;
+            jobCount = count;
+            nextIndex = 0;
+            active = (int)workers.size();
+            generation++;
+        }
+        wake.notify_all();
+        work();
+        // περιμενω να βγουν ολα τα νηματα απο αυτη τη δουλεια πριν αλλαξει το job
+        unique_lock<mutex> guard(lock);
+        finished.wait(guard, [&] { return active == 0; });
+        job = nullptr;
+    }
+};
+
+//γεωμετρια και βαθμολογηση μιας σαρωσης: ενα αντικειμενο ειναι ορατο αν dx στο [dxMin, dxMax] και dy στο
+//[dyMin, dyMax] ως προς το οχημα. αποσταση = wx*|dx| + wy*|dy| και
+//confidence = base * (1 - distance / scale) + θορυβος/100, κομμενο στο [0, 1]
+struct ScanParams {
+    int carX, carY;
+    int dxMin, dxMax, dyMin, dyMax;
+    int wx, wy;
+    float base, scale;
+    uint32_t noiseKey;
+    uint32_t tick;
+};
+
+//ο πυρηνας της σαρωσης πανω σε πακεταρισμενους πινακες x/y/handle. βγαζει μασκα (ενα bit ανα αντικειμενο,
+//8 ανα byte) και confidence/αποσταση για καθε θεση. υπαρχουν τρεις υλοποιησεις με ιδια αποτελεσματα bit προς bit
+//και η καλυτερη που υποστηριζει ο επεξεργαστης επιλεγεται μια φορα στην εκκινηση
+class ScanKernel {
+public:
+    enum class Isa : unsigned char { Scalar, SSE2, AVX2 };
+
+    static Isa active;
+
+    static Isa detect() {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) return Isa::AVX2;
+        if (__builtin_cpu_supports("sse2")) return Isa::SSE2;
+#endif
+        return Isa::Scalar;
+    }
+
+    static bool supported(Isa isa) { return (int)isa <= (int)detect(); }
+
+    static const char* isaName(Isa isa) {
+        switch (isa) {
+            case Isa::SSE2: return "sse2";
+            case Isa::AVX2: return "avx2";
+            default: return "scalar";
+        }
+    }
+
+    // mask πρεπει να εχει (n + 7) / 8 bytes, conf και dist n θεσεις
+    static void run(const ScanParams& p, const int* xs, const int* ys, const uint32_t* handles, int n,
+                    uint8_t* mask, float* conf, int* dist) {
+        run(active, p, xs, ys, handles, n, mask, conf, dist);
+    }
+
+    static void run(Isa isa, const ScanParams& p, const int* xs, const int* ys, const uint32_t* handles, int n,
+                    uint8_t* mask, float* conf, int* dist) {
+        int done = 0;
+#if defined(__x86_64__) || defined(__i386__)
+        if (isa == Isa::AVX2) done = runAvx2(p, xs, ys, handles, n, mask, conf, dist);
+        else if (isa == Isa::SSE2) done = runSse2(p, xs, ys, handles, n, mask, conf, dist);
+#endif
+        runScalar(p, xs, ys, handles, done, n, mask, conf, dist);
+    }
+
+private:
+    // ιδια πραξη με Rng::below(noiseKey, (tick << 32) | handle, 11) - 5
+    static int noise(const ScanParams& p, uint32_t handle) {
+        return Rng::below(p.noiseKey, ((uint64_t)p.tick << 32) | handle, 11) - 5;
+    }
+
+    // οι θεσεις απο το from και μετα, το from ειναι παντα πολλαπλασιο του 8
+    static void runScalar(const ScanParams& p, const int* xs, const int* ys, const uint32_t* handles, int from, int n,
+                          uint8_t* mask, float* conf, int* dist) {
+        for (int i = from; i < n; i++) {
+            if ((i & 7) == 0) mask[i >> 3] = 0;
+            int dx = xs[i] - p.carX;
+            int dy = ys[i] - p.carY;
+            bool hit = dx >= p.dxMin && dx <= p.dxMax && dy >= p.dyMin && dy <= p.dyMax;
+            int d = p.wx * abs(dx) + p.wy * abs(dy);
+            float c = p.base * (1.0f - (float)d / p.scale) + (float)noise(p, handles[i]) * 0.01f;
+            conf[i] = max(min(c, 1.0f), 0.0f);
+            dist[i] = d;
+            if (hit) mask[i >> 3] |= (uint8_t)(1u << (i & 7));
+        }
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+    // το SSE2 δεν εχει πολλαπλασιασμο 32-bit, τον φτιαχνω απο δυο 32x32->64
+    static __m128i mullo32(__m128i a, __m128i b) {
+        __m128i even = _mm_mul_epu32(a, b);
+        __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+        return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                                  _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+    }
+
+    static __m128i hash32(__m128i x) {
+        x = _mm_xor_si128(x, _mm_srli_epi32(x, 16));
+        x = mullo32(x, _mm_set1_epi32((int)0x7feb352dU));
+        x = _mm_xor_si128(x, _mm_srli_epi32(x, 15));
+        x = mullo32(x, _mm_set1_epi32((int)0x846ca68bU));
+        x = _mm_xor_si128(x, _mm_srli_epi32(x, 16));
+        return x;
+    }
+
+    // (h * n) >> 32 για καθε 32-bit λωριδα
+    static __m128i mulhi32(__m128i h, __m128i n) {
+        __m128i even = _mm_srli_epi64(_mm_mul_epu32(h, n), 32);
+        __m128i odd = _mm_and_si128(_mm_mul_epu32(_mm_srli_epi64(h, 32), n), _mm_set1_epi64x((long long)0xFFFFFFFF00000000ULL));
+        return _mm_or_si128(even, odd);
+    }
+
+    static __m128i abs32(__m128i v) {
+        __m128i sign = _mm_srai_epi32(v, 31);
+        return _mm_sub_epi32(_mm_xor_si128(v, sign), sign);
+    }
+
+    static int runSse2(const ScanParams& p, const int* xs, const int* ys, const uint32_t* handles, int n,
+                       uint8_t* mask, float* conf, int* dist) {
+        const __m128i carX = _mm_set1_epi32(p.carX), carY = _mm_set1_epi32(p.carY);
+        const __m128i dxLo = _mm_set1_epi32(p.dxMin - 1), dxHi = _mm_set1_epi32(p.dxMax + 1);
+        const __m128i dyLo = _mm_set1_epi32(p.dyMin - 1), dyHi = _mm_set1_epi32(p.dyMax + 1);
+        const __m128i wx = _mm_set1_epi32(p.wx), wy = _mm_set1_epi32(p.wy);
+        const __m128i key = _mm_set1_epi32((int)p.noiseKey);
+        const __m128i mix = _mm_set1_epi32((int)(p.tick ^ (p.noiseKey * 0x9E3779B9U)));
+        const __m128i eleven = _mm_set1_epi32(11), five = _mm_set1_epi32(5);
+        const __m128 base = _mm_set1_ps(p.base), scale = _mm_set1_ps(p.scale);
+        const __m128 one = _mm_set1_ps(1.0f), zero = _mm_setzero_ps(), hundredth = _mm_set1_ps(0.01f);
+
+        int i = 0;
+        for (; i + 8 <= n; i += 8) {
+            int bits = 0;
+            for (int half = 0; half < 2; half++) {
+                int k = i + half * 4;
+                __m128i dx = _mm_sub_epi32(_mm_loadu_si128((const __m128i*)(xs + k)), carX);
+                __m128i dy = _mm_sub_epi32(_mm_loadu_si128((const __m128i*)(ys + k)), carY);
+                __m128i in = _mm_and_si128(_mm_and_si128(_mm_cmpgt_epi32(dx, dxLo), _mm_cmplt_epi32(dx, dxHi)),
+                                           _mm_and_si128(_mm_cmpgt_epi32(dy, dyLo), _mm_cmplt_epi32(dy, dyHi)));
+                __m128i d = _mm_add_epi32(mullo32(wx, abs32(dx)), mullo32(wy, abs32(dy)));
+
+                __m128i h = _mm_loadu_si128((const __m128i*)(handles + k));
+                h = hash32(_mm_xor_si128(hash32(_mm_xor_si128(h, key)), mix));
+                __m128i noise = _mm_sub_epi32(mulhi32(h, eleven), five);
+
+                __m128 c = _mm_mul_ps(base, _mm_sub_ps(one, _mm_div_ps(_mm_cvtepi32_ps(d), scale)));
+                c = _mm_add_ps(c, _mm_mul_ps(_mm_cvtepi32_ps(noise), hundredth));
+                c = _mm_max_ps(_mm_min_ps(c, one), zero);
+
+                _mm_storeu_ps(conf + k, c);
+                _mm_storeu_si128((__m128i*)(dist + k), d);
+                bits |= _mm_movemask_ps(_mm_castsi128_ps(in)) << (half * 4);
+            }
+            mask[i >> 3] = (uint8_t)bits;
+        }
+        return i;
+    }
+
+    __attribute__((target("avx2")))
+    static __m256i hash32(__m256i x) {
+        x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 16));
+        x = _mm256_mullo_epi32(x, _mm256_set1_epi32((int)0x7feb352dU));
+        x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 15));
+        x = _mm256_mullo_epi32(x, _mm256_set1_epi32((int)0x846ca68bU));
+        x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 16));
+        return x;
+    }
+
+    __attribute__((target("avx2")))
+    static int runAvx2(const ScanParams& p, const int* xs, const int* ys, const uint32_t* handles, int n,
+                       uint8_t* mask, float* conf, int* dist) {
+        const __m256i carX = _mm256_set1_epi32(p.carX), carY = _mm256_set1_epi32(p.carY);
+        const __m256i dxLo = _mm256_set1_epi32(p.dxMin - 1), dxHi = _mm256_set1_epi32(p.dxMax + 1);
+        const __m256i dyLo = _mm256_set1_epi32(p.dyMin - 1), dyHi = _mm256_set1_epi32(p.dyMax + 1);
+        const __m256i wx = _mm256_set1_epi32(p.wx), wy = _mm256_set1_epi32(p.wy);
+        const __m256i key = _mm256_set1_epi32((int)p.noiseKey);
+        const __m256i mix = _mm256_set1_epi32((int)(p.tick ^ (p.noiseKey * 0x9E3779B9U)));
+        const __m256i eleven = _mm256_set1_epi32(11), five = _mm256_set1_epi32(5);
+        const __m256i hiMask = _mm256_set1_epi64x((long long)0xFFFFFFFF00000000ULL);
+        const __m256 base = _mm256_set1_ps(p.base), scale = _mm256_set1_ps(p.scale);
+        const __m256 one = _mm256_set1_ps(1.0f), zero = _mm256_setzero_ps(), hundredth = _mm256_set1_ps(0.01f);
+
+        int i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m256i dx = _mm256_sub_epi32(_mm256_loadu_si256((const __m256i*)(xs + i)), carX);
+            __m256i dy = _mm256_sub_epi32(_mm256_loadu_si256((const __m256i*)(ys + i)), carY);
+            __m256i in = _mm256_and_si256(_mm256_and_si256(_mm256_cmpgt_epi32(dx, dxLo), _mm256_cmpgt_epi32(dxHi, dx)),
+                                          _mm256_and_si256(_mm256_cmpgt_epi32(dy, dyLo), _mm256_cmpgt_epi32(dyHi, dy)));
+            __m256i d = _mm256_add_epi32(_mm256_mullo_epi32(wx, _mm256_abs_epi32(dx)), _mm256_mullo_epi32(wy, _mm256_abs_epi32(dy)));
+
+            __m256i h = _mm256_loadu_si256((const __m256i*)(handles + i));
+            h = hash32(_mm256_xor_si256(hash32(_mm256_xor_si256(h, key)), mix));
+            __m256i even = _mm256_srli_epi64(_mm256_mul_epu32(h, eleven), 32);
+            __m256i odd = _mm256_and_si256(_mm256_mul_epu32(_mm256_srli_epi64(h, 32), eleven), hiMask);
+            __m256i noise = _mm256_sub_epi32(_mm256_or_si256(even, odd), five);
+
+            __m256 c = _mm256_mul_ps(base, _mm256_sub_ps(one, _mm256_div_ps(_mm256_cvtepi32_ps(d), scale)));
+            c = _mm256_add_ps(c, _mm256_mul_ps(_mm256_cvtepi32_ps(noise), hundredth));
+            c = _mm256_max_ps(_mm256_min_ps(c, one), zero);
+
+            _mm256_storeu_ps(conf + i, c);
+            _mm256_storeu_si256((__m256i*)(dist + i), d);
+            mask[i >> 3] = (uint8_t)_mm256_movemask_ps(_mm256_castsi256_ps(in));
+        }
+        return i;
+    }
+#endif
+};
+
+ScanKernel::Isa ScanKernel::active = ScanKernel::detect();
+
+//οπτικη επαφη πανω στα κατειλημενα κελια του κοσμου. η load αντιγραφει απο το ευρετηριο του GridWorld τις λεξεις
+//γυρω απο ενα σημειο (64 bit για καθε μπλοκ 8x8, οπως τα tiles του), οι ακτινες περπατανε με Bresenham και
+//τα κελια τους μεσα σε ενα μπλοκ μαζευονται σε μια μασκα που ελεγχεται με ενα AND πανω στη λεξη του
+class LineOfSight {
+public:
+    static constexpr int SHIFT = 3;
+
+private:
+    int bx0, by0, bw, bh;     // πρωτο μπλοκ και διαστασεις του παραθυρου σε μπλοκ
+    vector<uint64_t> words;   // γραμμη γραμμη
+
+    uint64_t word(int bx, int by) const {
+        bx -= bx0;
+        by -= by0;
+        return bx >= 0 && bx < bw && by >= 0 && by < bh ? words[by * bw + bx] : 0;
+    }
+
+public:
+    LineOfSight() : bx0(0), by0(0), bw(0), bh(0) { words.reserve(16); }
+
+    // φορτωνει τα μπλοκ που καλυπτουν το [x0,x1]x[y0,y1], οτι ειναι εξω απο αυτα μετραει για αδειο
+    void load(const GridWorld& world, int x0, int y0, int x1, int y1);
+
+    bool occupied(int x, int y) const { return (word(x >> SHIFT, y >> SHIFT) >> (((y & 7) << 3) | (x & 7))) & 1; }
+
+    // true αν κανενα κελι της ακτινας απο το (ax,ay) στο (bx,by) δεν ειναι κατειλημενο, χωρις τα δυο ακρα
+    bool clear(int ax, int ay, int bx, int by) const {
+        if (ax == bx && ay == by) return true;
+        int dx = abs(bx - ax), dy = -abs(by - ay);
+        int sx = ax < bx ? 1 : -1, sy = ay < by ? 1 : -1;
+        int err = dx + dy;
+        int x = ax, y = ay;
+        int blockX = x >> SHIFT, blockY = y >> SHIFT;
+        uint64_t ray = 0;
+        while (true) {
+            int e2 = 2 * err;
+            if (e2 >= dy) { err += dy; x += sx; }
+            if (e2 <= dx) { err += dx; y += sy; }
+            if (x == bx && y == by) break;
+            if ((x >> SHIFT) != blockX || (y >> SHIFT) != blockY) {
+                if (ray & word(blockX, blockY)) return false;
+                ray = 0;
+                blockX = x >> SHIFT;
+                blockY = y >> SHIFT;
+            }
+            ray |= 1ULL << (((y & 7) << 3) | (x & 7));
+        }
+        return !(ray & word(blockX, blockY));
     }
 };
 
@@ -74,236 +702,1060 @@ protected:
     Position position;
     string type;
     string sensorId;
-    static int sensorCounter;
+    static thread_local int sensorCounter;
+    // καθε αισθητηρας εχει δικη του ροη θορυβου και ο θορυβος καθε αναγνωσης εξαρταται μονο απο
+    // (tick, αντικειμενο), ετσι δεν εχει σημασια η σειρα ή το νημα που σκαναρει
+    uint32_t noiseKey;
+    // το οχημα που φερει τον αισθητηρα, μεσα στον κοσμο δεν πρεπει να βλεπει τον εαυτο του
+    Handle owner;
+    vector<int> candidates;
+    // οι υποψηφιοι πακεταρισμενοι για τον ScanKernel και τα αποτελεσματα του
+    vector<int> packedX, packedY;
+    vector<uint32_t> packedHandle;
+    vector<uint8_t> hitMask;
+    vector<float> hitConfidence;
+    vector<int> hitDistance;
+    LineOfSight sight;
+
+    // κουτι μπροστα απο το οχημα: 1..length κατα τη φορα του και το πολυ halfWidth δεξια/αριστερα
+    static void frontBox(Dir dir, int length, int halfWidth, ScanParams& p) {
+        p.dxMin = -halfWidth; p.dxMax = halfWidth;
+        p.dyMin = -halfWidth; p.dyMax = halfWidth;
+        if (dir == Dir::E) { p.dxMin = 1; p.dxMax = length; }
+        else if (dir == Dir::W) { p.dxMin = -length; p.dxMax = -1; }
+        else if (dir == Dir::N) { p.dyMin = 1; p.dyMax = length; }
+        else if (dir == Dir::S) { p.dyMin = -length; p.dyMax = -1; }
+        else { p.dxMin = 1; p.dxMax = 0; } // χωρις κατευθυνση δεν βλεπει τιποτα
+    }
+
+    ScanParams baseParams(const GridWorld& world, int carX, int carY, float base, float scale) const;
+
+    // βαθμολογει τους candidates με τον ScanKernel και προσθετει οσους βρηκε στο results, με τη σειρα τους.
+    // με lineOfSight κραταει μονο οσους δεν κρυβει αλλο κατειλημενο κελι αναμεσα
+    void emitHits(const GridWorld& world, const ScanParams& p, bool movingOnly, bool lineOfSight, vector<SensorReading>& results);
 public:
-    Sensor(string t, int x, int y) : type(t), position(x, y) {
+    Sensor(string t, int x, int y) : type(t), position(x, y), owner(0xFFFFFFFF) {
         sensorCounter++;
         sensorId = t + ":" + to_string(sensorCounter);
+        noiseKey = Rng::key(Rng::SensorNoise, sensorCounter);
+        // χωρητικοτητα για ενα γεματο οπτικο πεδιο απο την αρχη, ωστε να μη μεγαλωνουν οταν πρωτοεμφανιστει κατι
+        const int typical = 96;
+        candidates.reserve(typical);
+        packedX.reserve(typical);
+        packedY.reserve(typical);
+        packedHandle.reserve(typical);
+        hitMask.reserve(typical / 8);
+        hitConfidence.reserve(typical);
+        hitDistance.reserve(typical);
     }
     
     virtual ~Sensor() {}
+
+    static void resetCounter() { sensorCounter = 0; }
+    static int getCounter() { return sensorCounter; }
+    static void setCounter(int value) { sensorCounter = value; }
+
+    void setOwner(Handle h) { owner = h; }
     
     void setPosition(int x, int y) {
         position.x = x;
         position.y = y;
     }
     
-    virtual vector<SensorReading> scan(const GridWorld& world, int carX, int carY, string carDir) = 0;
+    // προσθετει τις αναγνωσεις του στο results (που κραταει τη χωρητικοτητα του απο tick σε tick)
+    virtual void scan(const GridWorld& world, int carX, int carY, Dir carDir, vector<SensorReading>& results) = 0;
     
     string getType() const { return type; }
     string getId() const { return sensorId; }
 };
 
-int Sensor::sensorCounter = 0;
+thread_local int Sensor::sensorCounter = 0;
+
+//αποθηκη οντοτητων του κοσμου σε μορφη structure-of-arrays: καθε πεδιο ειναι ενας συνεχομενος πινακας
+//και καθε οντοτητα ειναι μια θεση (slot) σε ολους τους πινακες. τα Object ειναι απλα προσοψη πανω της
+class EntityStore {
+public:
+    vector<int> x, y;
+    vector<int> speed;
+    vector<Dir> dir;
+    vector<Kind> kind;
+    vector<Handle> handle;
+    vector<int> lightPhase;           // η θεση των φαναριων στον κυκλο τους στο tick 0
+    vector<int> cellNext, cellPrev;   // διπλα συνδεδεμενη λιστα των οντοτητων του ιδιου κελιου
+    vector<Object*> owner;
+    int lightClock;                   // ticks που εχουν περασει για τα φαναρια
+
+    EntityStore() : lightClock(0) {}
+
+    int size() const { return (int)x.size(); }
+
+    Light light(int s) const { return kind[s] == Kind::TrafficLight ? lightAt(lightPhase[s], lightClock) : Light::None; }
+
+    void reserve(int n) {
+        x.reserve(n); y.reserve(n); speed.reserve(n); dir.reserve(n); kind.reserve(n);
+        handle.reserve(n); lightPhase.reserve(n); cellNext.reserve(n); cellPrev.reserve(n); owner.reserve(n);
+    }
+
+    int add(Object* obj, Kind k, Handle h, Position pos, int spd, Dir d, int phase) {
+        x.push_back(pos.x);
+        y.push_back(pos.y);
+        speed.push_back(spd);
+        dir.push_back(d);
+        kind.push_back(k);
+        handle.push_back(h);
+        lightPhase.push_back(phase);
+        cellNext.push_back(-1);
+        cellPrev.push_back(-1);
+        owner.push_back(obj);
+        return size() - 1;
+    }
+
+    // αντιγραφει ολα τα πεδια του slot from στο slot to
+    void copySlot(int from, int to) {
+        x[to] = x[from]; y[to] = y[from]; speed[to] = speed[from]; dir[to] = dir[from];
+        kind[to] = kind[from]; handle[to] = handle[from]; lightPhase[to] = lightPhase[from];
+        cellNext[to] = cellNext[from]; cellPrev[to] = cellPrev[from]; owner[to] = owner[from];
+    }
+
+    void popBack() {
+        x.pop_back(); y.pop_back(); speed.pop_back(); dir.pop_back(); kind.pop_back(); handle.pop_back();
+        lightPhase.pop_back(); cellNext.pop_back(); cellPrev.pop_back(); owner.pop_back();
+    }
+
+    // βγαζει τα slot του removed (σε αυξουσα σειρα), τα υπολοιπα κρατανε τη σειρα τους. καθε στηλη
+    // μετακινειται σε κομματια, τα διαστηματα αναμεσα στα slot που βγαινουν
+    void compact(const vector<int>& removed) {
+        compactColumn(x, removed); compactColumn(y, removed); compactColumn(speed, removed); compactColumn(dir, removed);
+        compactColumn(kind, removed); compactColumn(handle, removed); compactColumn(lightPhase, removed);
+        compactColumn(cellNext, removed); compactColumn(cellPrev, removed); compactColumn(owner, removed);
+    }
+
+private:
+    template <typename V>
+    static void compactColumn(V& column, const vector<int>& removed) {
+        auto to = column.begin() + removed[0];
+        for (size_t r = 0; r < removed.size(); r++) {
+            auto end = r + 1 < removed.size() ? column.begin() + removed[r + 1] : column.end();
+            to = move(column.begin() + removed[r] + 1, end, to);
+        }
+        column.erase(to, column.end());
+    }
+};
 
 //βασικη κλαση για ολα τα αντικειμενα στον κοσμο
 class Object {
+    friend class GridWorld;
 protected:
     Position position;
     ID id;
-    string glyph;
-    static map<string, int> objectCounters;
+    char glyph;
+    static thread_local int objectCounters[6];
+    // οταν το αντικειμενο μπει σε κοσμο τα δεδομενα του ζουν στο EntityStore του κοσμου (θεση slot)
+    EntityStore* store;
+    int slot;
 public:
-    Object() : id{"", 0}, glyph(""), position(0, 0) {}
-    
-    Object(string type, int num, string g, Position pos) 
-        : id{type, num}, glyph(g), position(pos) {
+    Object(Kind kind, int num, char g, Position pos) 
+        : id{kind, num}, glyph(g), position(pos), store(nullptr), slot(-1) {
     }
     
     virtual ~Object() {}
     
+    // μονο για αντικειμενα εκτος κοσμου, μεσα στον κοσμο η θεση αλλαζει μεσω GridWorld
     void setPosition(int x, int y) {
         position.x = x;
         position.y = y;
     }
     
     virtual Position getPosition() const { 
+        if (store) return Position(store->x[slot], store->y[slot]);
         return position;
     }
 
+    bool inWorld() const { return store != nullptr; }
+    int getSlot() const { return slot; }
+
+    // γραφει τα πεδια του αντικειμενου σε μια νεα θεση του store και επιστρεφει το slot
+    virtual int attach(EntityStore& s) {
+        return s.add(this, getKind(), getHandle(), position, 0, Dir::None, 0);
+    }
+
     //ολα τα getters
+    virtual Kind getKind() const = 0;
     virtual string getType() const = 0;
     virtual string getID() const { return id.toString(); }
-    virtual string getGlyph() const { return glyph; }
+    Handle getHandle() const { return id.handle(); }
+    virtual char getGlyph() const { return glyph; }
     virtual int getSpeed() const { return 0; }
-    virtual string getDirection() const { return ""; }
+    virtual Dir getDirection() const { return Dir::None; }
     virtual string getSignText() const { return ""; }
-    virtual string getTrafficLight() const { return ""; }
+    virtual Light getTrafficLight() const { return Light::None; }
     
     virtual void update(int tick) {}
     
-    static int getNextId(string type) {
-        return ++objectCounters[type];
+    static int getNextId(Kind kind) {
+        return ++objectCounters[(int)kind];
+    }
+
+    static void resetCounters() {
+        for (int& counter : objectCounters) counter = 0;
     }
+
+    static int getCounter(Kind kind) { return objectCounters[(int)kind]; }
+    static void setCounter(Kind kind, int value) { objectCounters[(int)kind] = value; }
 };
 
-map<string, int> Object::objectCounters;
+thread_local int Object::objectCounters[6];
 
-//κλασση που αντιπροσοπευει τον κοσμο της προσομοιωσης
-class GridWorld {
+//πινακας κατακερματισμου ανοιχτης διευθυνσης (linear probing) απο κελι σε int. δεν δεσμευει μνημη
+//σε καθε εισαγωγη οπως το unordered_map και η διαγραφη μετακινει πισω τα επομενα στοιχεια (χωρις tombstones)
+class CellMap {
 private:
-    int dimX, dimY;
-    vector<Object*> objects;
+    static constexpr long long EMPTY = LLONG_MIN;
+    vector<long long> keys;
+    vector<int> values;
+    size_t count;
+    size_t mask;
 
-public:
-    GridWorld(int x, int y) : dimX(x), dimY(y) {
-        cout << "[+WORLD: GRID] Reticulating splines – Hello, world!" << endl;
+    size_t bucketOf(long long key) const {
+        unsigned long long h = (unsigned long long)key * 0x9E3779B97F4A7C15ULL;
+        return (size_t)(h ^ (h >> 29)) & mask;
     }
 
-    ~GridWorld() {
-        for (auto obj : objects) {
-            delete obj;
+    void grow() {
+        vector<long long> oldKeys;
+        vector<int> oldValues;
+        oldKeys.swap(keys);
+        oldValues.swap(values);
+        size_t capacity = oldKeys.empty() ? 16 : oldKeys.size() * 2;
+        keys.assign(capacity, EMPTY);
+        values.assign(capacity, 0);
+        mask = capacity - 1;
+        count = 0;
+        for (size_t i = 0; i < oldKeys.size(); i++) {
+            if (oldKeys[i] != EMPTY) set(oldKeys[i], oldValues[i]);
         }
-        cout << "[-WORLD: GRID] Goodbye, cruel world!" << endl;
     }
 
-    void addObject(Object* obj) {
-        objects.push_back(obj);
+public:
+    CellMap() : count(0), mask(0) {}
+
+    size_t size() const { return count; }
+
+    // χωρος για n κλειδια χωρις να μεγαλωσει ο πινακας
+    void reserve(size_t n) {
+        while (n * 2 > keys.size()) grow();
     }
 
-    vector<Object*> getObjects() const {
-        return objects;
+    // αδειαζει κρατωντας τη χωρητικοτητα
+    void clear() {
+        fill(keys.begin(), keys.end(), EMPTY);
+        count = 0;
     }
-    
-    Object* getObjectAt(int x, int y) const {
-        for (auto obj : objects) {
-            Position pos = obj->getPosition();
-            if (pos.x == x && pos.y == y) {
-                return obj;
-            }
+
+    const int* find(long long key) const {
+        if (keys.empty()) return nullptr;
+        for (size_t i = bucketOf(key); keys[i] != EMPTY; i = (i + 1) & mask) {
+            if (keys[i] == key) return &values[i];
         }
         return nullptr;
     }
 
-    bool inBounds(int x, int y) const {
-        return x >= 0 && x < dimX && y >= 0 && y < dimY;
+    int* find(long long key) {
+        return const_cast<int*>(static_cast<const CellMap*>(this)->find(key));
     }
-    
-    int getDimX() const { return dimX; }
-    int getDimY() const { return dimY; }
-    
-    //συναρτηση που καλει την update ολων των αντικειμενων
-    void updateAll(int tick) {
-        for (auto obj : objects) {
-            obj->update(tick);
+
+    void set(long long key, int value) {
+        if ((count + 1) * 2 > keys.size()) grow();
+        size_t i = bucketOf(key);
+        while (keys[i] != EMPTY && keys[i] != key) i = (i + 1) & mask;
+        if (keys[i] == EMPTY) {
+            keys[i] = key;
+            count++;
         }
+        values[i] = value;
     }
-    
-    //συναρτηση για την αφαιρεση αντικειμενων απο τον κοσμο
-    void removeObject(Object* obj) {
-        auto it = find(objects.begin(), objects.end(), obj);
-        if (it != objects.end()) {
-            delete *it;
-            objects.erase(it);
+
+    void erase(long long key) {
+        if (keys.empty()) return;
+        size_t i = bucketOf(key);
+        while (keys[i] != key) {
+            if (keys[i] == EMPTY) return;
+            i = (i + 1) & mask;
+        }
+        keys[i] = EMPTY;
+        count--;
+        // φερνω πισω οσα στοιχεια της ιδιας αλυσιδας θα χανονταν μετα το κενο
+        for (size_t j = (i + 1) & mask; keys[j] != EMPTY; j = (j + 1) & mask) {
+            size_t home = bucketOf(keys[j]);
+            bool between = (i <= j) ? (home > i && home <= j) : (home > i || home <= j);
+            if (!between) {
+                keys[i] = keys[j];
+                values[i] = values[j];
+                keys[j] = EMPTY;
+                i = j;
+            }
+        }
+    }
+
+    // καλει την f(key, value) για καθε στοιχειο
+    template <typename F>
+    void forEach(F f) const {
+        for (size_t i = 0; i < keys.size(); i++) {
+            if (keys[i] != EMPTY) f(keys[i], values[i]);
         }
     }
 };
 
-//κλάση για αισθητηρα lidar
-class LidarSensor : public Sensor {
+//πλεγμα κελιων χωρισμενο σε tiles TILE x TILE που δεσμευονται μονο οταν γραφτει σε αυτα τιμη διαφορετικη
+//απο την empty, ετσι η μνημη ακολουθει την περιοχη που χρησιμοποιειται και οχι το dimX*dimY. τα tiles
+//βρισκονται μεσω CellMap. με την set οσα αδειαζουν βγαινουν απο το ευρετηριο αλλα μενουν στη θεση τους για το
+//επομενο tile που θα χρειαστει, ετσι οντοτητες που πηγαινοερχονται στα ορια των tiles δεν δεσμευουν μνημη.
+//η μνημη φτανει το πολυ οσο το μεγιστο πληθος tiles που υπηρξαν μαζι και επιστρεφεται με την clear
+template <typename T>
+class ChunkedGrid {
 public:
-    LidarSensor(int x, int y) : Sensor("LIDAR", x, y) {
-        cout << "[+LIDAR: " << sensorId << "] Lidar sensor ready – Sensing with pew pews!" << endl;
+    static constexpr int SHIFT = 3;
+    static constexpr int TILE = 1 << SHIFT;   // 8x8 κελια
+
+private:
+    static constexpr int MASK = TILE - 1;
+    static constexpr size_t SPARE = 64;   // tiles που κραταει η clear για ξαναχρηση
+
+    struct Tile {
+        T cells[TILE * TILE];
+        int used;          // κελια με τιμη διαφορετικη απο την empty
+        uint64_t filled;   // ενα bit για καθε τετοιο κελι, στη θεση cellIndex
+    };
+
+    T empty;
+    CellMap index;                    // tile -> θεση στο tiles
+    vector<unique_ptr<Tile>> tiles;
+    vector<int> freeSlots;            // θεσεις του tiles εκτος ευρετηριου, το tile τους μενει για ξαναχρηση
+    long long cachedKey;              // το τελευταιο tile της at/peek
+    Tile* cachedTile;
+
+    static long long tileKey(int x, int y) {
+        return ((long long)(x >> SHIFT) << 32) | (unsigned int)(y >> SHIFT);
     }
-    
-    virtual ~LidarSensor() { 
-        cout << "[-SENSOR: " << sensorId << "] Sensor destroyed – No further data from me!" << endl;
+
+    static int cellIndex(int x, int y) { return ((y & MASK) << SHIFT) | (x & MASK); }
+
+    Tile* tileAt(int x, int y) const {
+        const int* t = index.find(tileKey(x, y));
+        return t ? tiles[*t].get() : nullptr;
     }
 
-    vector<SensorReading> scan(const GridWorld& world, int carX, int carY, string carDir) override {
-        vector<SensorReading> results;
-        int range = 4; // 9x9 area
+    Tile* cachedTileAt(int x, int y) {
+        long long key = tileKey(x, y);
+        if (key == cachedKey) return cachedTile;
+        const int* t = index.find(key);
+        if (!t) return nullptr;
+        cachedKey = key;
+        cachedTile = tiles[*t].get();
+        return cachedTile;
+    }
 
-        for (auto obj : world.getObjects()) {
-            Position pos = obj->getPosition();
-            int dx = pos.x - carX;
-            int dy = pos.y - carY;
-
-            if (abs(dx) <= range && abs(dy) <= range) {
-                SensorReading reading;
-                reading.objectType = obj->getType();
-                reading.objectId = obj->getID();
-                reading.position = pos;
-                reading.distance = abs(dx) + abs(dy);
-                
-                // Base confidence with noise
-                double baseConfidence = 0.99;
-                double distanceFactor = 1.0 - (reading.distance / (double)(range * 2));
-                reading.confidence = baseConfidence * distanceFactor;
-                reading.confidence += ((rand() % 11) - 5) * 0.01;
-                reading.confidence = max(0.0, min(1.0, reading.confidence));
-                
-                reading.speed = obj->getSpeed();
-                reading.direction = obj->getDirection();
-                reading.signText = obj->getSignText();
-                reading.trafficLight = obj->getTrafficLight();
-                results.push_back(reading);
-            }
+    Tile* allocate(int x, int y) {
+        int slot;
+        if (!freeSlots.empty()) {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            slot = (int)tiles.size();
+            tiles.push_back(unique_ptr<Tile>(new Tile));
+            // το freeSlots δεν ξεπερναει ποτε το tiles, με την ιδια χωρητικοτητα δεν μεγαλωνει οταν αδειαζουν tiles
+            if (freeSlots.capacity() < tiles.capacity()) freeSlots.reserve(tiles.capacity());
         }
+        Tile* tile = tiles[slot].get();
+        fill(begin(tile->cells), end(tile->cells), empty);
+        tile->used = 0;
+        tile->filled = 0;
+        index.set(tileKey(x, y), slot);
+        return tile;
+    }
 
-        return results;
+    void release(int x, int y) {
+        long long key = tileKey(x, y);
+        freeSlots.push_back(*index.find(key));
+        index.erase(key);
+        if (key == cachedKey) cachedKey = LLONG_MIN;
     }
-};
 
-//κλάση για αισθητηρα radar
-class RadarSensor : public Sensor {
 public:
-    RadarSensor(int x, int y) : Sensor("RADAR", x, y) {
-        cout << "[+RADAR: " << sensorId << "] Radar sensor ready – I'm a Radio star!" << endl;
+    explicit ChunkedGrid(const T& emptyValue) : empty(emptyValue), cachedKey(LLONG_MIN), cachedTile(nullptr) {}
+
+    T get(int x, int y) const {
+        const Tile* tile = tileAt(x, y);
+        return tile ? tile->cells[cellIndex(x, y)] : empty;
+    }
+
+    void set(int x, int y, const T& value) {
+        Tile* tile = tileAt(x, y);
+        if (!tile) {
+            if (value == empty) return;
+            tile = allocate(x, y);
+        }
+        T& cell = tile->cells[cellIndex(x, y)];
+        tile->used += (int)(cell == empty) - (int)(value == empty);
+        uint64_t bit = 1ULL << cellIndex(x, y);
+        tile->filled = value == empty ? tile->filled & ~bit : tile->filled | bit;
+        cell = value;
+        if (tile->used == 0) release(x, y);
+    }
+
+    // αναφορα στο κελι, δεσμευει το tile αν δεν υπαρχει. δεν μετραει τα γεματα κελια, αυτα τα tiles μενουν
+    // μεχρι την clear (για πλεγματα που ξαναγεμιζουν απο την αρχη, οπως του PathPlanner) και η filledBits
+    // τα δινει ολα γεματα. μαζι με την peek θυμαται το τελευταιο tile, αρα δεν ειναι για πλεγματα που
+    // διαβαζονται απο πολλα νηματα
+    T& at(int x, int y) {
+        Tile* tile = cachedTileAt(x, y);
+        if (!tile) {
+            tile = allocate(x, y);
+            tile->used = TILE * TILE;
+            tile->filled = ~0ULL;
+        }
+        return tile->cells[cellIndex(x, y)];
+    }
+
+    const T& peek(int x, int y) {
+        Tile* tile = cachedTileAt(x, y);
+        return tile ? tile->cells[cellIndex(x, y)] : empty;
+    }
+
+    // αλλαζει ενα κελι που δεν ειναι empty σε αλλη τιμη που επισης δεν ειναι, αρα το tile ουτε δεσμευεται
+    // ουτε αδειαζει. θυμαται το tile οπως η at
+    void replace(int x, int y, const T& value) { cachedTileAt(x, y)->cells[cellIndex(x, y)] = value; }
+
+    void clear() {
+        if (tiles.size() > SPARE) tiles.resize(SPARE);
+        freeSlots.clear();
+        for (int slot = (int)tiles.size() - 1; slot >= 0; slot--) freeSlots.push_back(slot);
+        index = CellMap();
+        cachedKey = LLONG_MIN;
+    }
+
+    size_t tileCount() const { return index.size(); }
+    size_t memoryBytes() const { return tiles.size() * sizeof(Tile); }
+
+    // τα γεματα κελια του tile (tx, ty) σε μια λεξη, bit (y % TILE) * TILE + x % TILE. 0 αν δεν υπαρχει
+    uint64_t filledBits(int tx, int ty) const {
+        const int* t = index.find(((long long)tx << 32) | (unsigned int)ty);
+        return t ? tiles[*t]->filled : 0;
+    }
+
+    // καλει την f(x, y, value) για καθε κελι του [x0,x1]x[y0,y1] με τιμη διαφορετικη απο την empty. αν το
+    // ορθογωνιο πιανει λιγοτερα tiles απο οσα υπαρχουν τα ρωταει γραμμη γραμμη (σειρα y και μετα x),
+    // αλλιως περναει μονο τα υπαρχοντα tiles
+    template <typename F>
+    void forEachInRect(int x0, int y0, int x1, int y1, F f) const {
+        if (x0 > x1 || y0 > y1) return;
+        int tx0 = x0 >> SHIFT, tx1 = x1 >> SHIFT;
+        long long tileArea = (long long)(tx1 - tx0 + 1) * ((y1 >> SHIFT) - (y0 >> SHIFT) + 1);
+        if (tileArea <= (long long)index.size()) {
+            for (int y = y0; y <= y1; y++) {
+                for (int tx = tx0; tx <= tx1; tx++) {
+                    const Tile* tile = tileAt(tx << SHIFT, y);
+                    if (!tile) continue;
+                    const T* row = &tile->cells[(y & MASK) << SHIFT];
+                    int xEnd = min(x1, (tx << SHIFT) + MASK);
+                    for (int x = max(x0, tx << SHIFT); x <= xEnd; x++) {
+                        if (!(row[x & MASK] == empty)) f(x, y, row[x & MASK]);
+                    }
+                }
+            }
+        } else {
+            index.forEach([&](long long key, int slot) {
+                int baseX = (int)(key >> 32) << SHIFT;
+                int baseY = (int)(unsigned int)key << SHIFT;
+                if (baseX + MASK < x0 || baseX > x1 || baseY + MASK < y0 || baseY > y1) return;
+                const Tile* tile = tiles[slot].get();
+                for (int y = max(y0, baseY); y <= min(y1, baseY + MASK); y++) {
+                    for (int x = max(x0, baseX); x <= min(x1, baseX + MASK); x++) {
+                        const T& value = tile->cells[cellIndex(x, y)];
+                        if (!(value == empty)) f(x, y, value);
+                    }
+                }
+            });
+        }
+    }
+};
+
+//δεξαμενη μνημης για αντικειμενα ιδιου μεγεθους: κομματια των ~64KB που δεν μετακινουνται ποτε (οι δεικτες
+//μενουν σταθεροι) και λιστα ελευθερων θεσεων μεσα στις ιδιες τις θεσεις, ετσι δημιουργια και καταστροφη ειναι
+//O(1) χωρις κληση στο heap και τα αντικειμενα του ιδιου ειδους ειναι διπλα διπλα στη μνημη
+class ObjectPool {
+private:
+    static const size_t CHUNK_BYTES = 1 << 16;
+
+    vector<unique_ptr<char[]>> chunks;
+    size_t blockSize;        // μεγεθος θεσης, πολλαπλασιο της μεγιστης ευθυγραμμισης
+    size_t perChunk;
+    size_t used;             // θεσεις του τελευταιου κομματιου που εχουν δοθει
+    void* freeList;          // καθε ελευθερη θεση κραταει στην αρχη της την επομενη
+    int live;
+
+public:
+    ObjectPool() : blockSize(0), perChunk(0), used(0), freeList(nullptr), live(0) {}
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    // το πρωτο allocate οριζει το μεγεθος των θεσεων
+    void* allocate(size_t size) {
+        if (blockSize == 0) {
+            size_t align = alignof(max_align_t);
+            blockSize = (max(size, sizeof(void*)) + align - 1) / align * align;
+            perChunk = max<size_t>(1, CHUNK_BYTES / blockSize);
+            used = perChunk;
+        }
+        live++;
+        if (freeList) {
+            void* p = freeList;
+            freeList = *(void**)p;
+            return p;
+        }
+        if (used == perChunk) {
+            chunks.emplace_back(new char[perChunk * blockSize]);
+            used = 0;
+        }
+        return chunks.back().get() + blockSize * used++;
+    }
+
+    void release(void* p) {
+        *(void**)p = freeList;
+        freeList = p;
+        live--;
+    }
+
+    int size() const { return live; }
+    size_t memoryBytes() const { return chunks.size() * perChunk * blockSize; }
+};
+
+//συγκρουσεις των κινουμενων (ποδηλατα, αυτοκινητα και αυτονομα οχηματα) μεσα σε ενα tick. καθε κινουμενο ειναι
+//σημειο που πηγαινει ευθεια απο το κελι που ξεκινησε το tick στο κελι που το τελειωσε, και δυο συγκρουονται
+//αν καποια στιγμη απεχουν λιγοτερο απο ενα κελι: στο ιδιο κελι στο τελος ή σε διασταυρωση στη διαδρομη
+//(μετωπικα ή καθετα). broad phase με κουβαδες κελιων: καθε διαδρομη μπαινει στα κελια που περναει και
+//ζευγη ελεγχονται μονο μεσα στον ιδιο κουβα, αρα το κοστος ειναι γραμμικο στα κινουμενα. οι πινακες
+//ξαναχρησιμοποιουνται απο tick σε tick
+class CollisionDetector {
+public:
+    struct Event {
+        Handle a, b;        // a < b
+        bool crossing;      // στη διαδρομη, αλλιως στο ιδιο κελι στο τελος
+        Position cell;      // εκει που βρεθηκαν
+    };
+
+private:
+    struct Path {
+        Handle handle;
+        Position from, to;
+    };
+
+    vector<Path> paths;
+    CellMap buckets;          // κελι -> τελευταια εγγραφη του κουβα
+    vector<int> entryPath;    // εγγραφες των κουβαδων: η διαδρομη και η επομενη εγγραφη του ιδιου κελιου
+    vector<int> entryNext;
+    vector<Event> events;
+
+    static long long cellKey(int x, int y) { return ((long long)x << 32) | (unsigned int)y; }
+
+    // τα κελια της διαδρομης, πρωτα κατα x και μετα κατα y (οι κινησεις ειναι σε εναν αξονα)
+    template <typename F>
+    static void forEachCell(const Path& p, F f) {
+        int x = p.from.x, y = p.from.y;
+        f(x, y);
+        while (x != p.to.x) f(x += (p.to.x > x ? 1 : -1), y);
+        while (y != p.to.y) f(x, y += (p.to.y > y ? 1 : -1));
+    }
+
+    // λυνει |r0 + t v| < 1 σε καθε αξονα για t στο [0, 1] (r0, v η σχετικη θεση και κινηση του b ως προς το a).
+    // τα διαστηματα των αξονων ειναι ανοιχτα, αρα υπαρχει επαφη μονο αν lo < hi
+    static bool contact(const Path& a, const Path& b, double& lo, double& hi) {
+        int r0[2] = {b.from.x - a.from.x, b.from.y - a.from.y};
+        int v[2] = {(b.to.x - b.from.x) - (a.to.x - a.from.x), (b.to.y - b.from.y) - (a.to.y - a.from.y)};
+        lo = 0;
+        hi = 1;
+        for (int k = 0; k < 2; k++) {
+            if (v[k] == 0) {
+                if (r0[k] != 0) return false;
+                continue;
+            }
+            double t0 = (-1.0 - r0[k]) / v[k], t1 = (1.0 - r0[k]) / v[k];
+            lo = max(lo, min(t0, t1));
+            hi = min(hi, max(t0, t1));
+        }
+        return lo < hi;
+    }
+
+    void test(int i, int j) {
+        // το σημειο της συγκρουσης μετριεται παντα απο τη διαδρομη του μικροτερου handle, ωστε να μην
+        // εξαρταται απο τη σειρα των οντοτητων στο store
+        if (paths[j].handle < paths[i].handle) swap(i, j);
+        const Path& a = paths[i];
+        const Path& b = paths[j];
+        // οσα ξεκινησαν στο ιδιο κελι συγκρουστηκαν ηδη σε προηγουμενο tick
+        if (a.from == b.from) return;
+        double lo, hi;
+        if (!contact(a, b, lo, hi)) return;
+        Event e;
+        e.a = min(a.handle, b.handle);
+        e.b = max(a.handle, b.handle);
+        e.crossing = a.to != b.to;
+        double t = (lo + hi) / 2;
+        e.cell = e.crossing ? Position((int)lround(a.from.x + t * (a.to.x - a.from.x)), (int)lround(a.from.y + t * (a.to.y - a.from.y)))
+                            : a.to;
+        events.push_back(e);
+    }
+
+public:
+    // νεο tick: ξεχναει τις διαδρομες του προηγουμενου
+    void clear() { paths.clear(); }
+
+    // το κινουμενο handle πηγε απο from στο to σε αυτο το tick (from == to αν εμεινε ακινητο)
+    void add(Handle handle, Position from, Position to) { paths.push_back({handle, from, to}); }
+
+    // βρισκει τις συγκρουσεις των διαδρομων του tick, μια για καθε ζευγος, και επιστρεφει ποσες ειναι
+    int detect() {
+        events.clear();
+        buckets.clear();
+        entryPath.clear();
+        entryNext.clear();
+        for (int p = 0; p < (int)paths.size(); p++) {
+            forEachCell(paths[p], [&](int x, int y) {
+                long long key = cellKey(x, y);
+                const int* last = buckets.find(key);
+                entryNext.push_back(last ? *last : -1);
+                entryPath.push_back(p);
+                buckets.set(key, (int)entryPath.size() - 1);
+            });
+        }
+        buckets.forEach([&](long long, int last) {
+            for (int i = last; i != -1; i = entryNext[i]) {
+                for (int j = entryNext[i]; j != -1; j = entryNext[j]) {
+                    if (entryPath[i] != entryPath[j]) test(entryPath[i], entryPath[j]);
+                }
+            }
+        });
+        // ζευγη που μοιραζονται παραπανω απο ενα κελι βρεθηκαν σε καθε κουβα τους
+        sort(events.begin(), events.end(), [](const Event& x, const Event& y) {
+            return x.a != y.a ? x.a < y.a : x.b < y.b;
+        });
+        events.erase(unique(events.begin(), events.end(), [](const Event& x, const Event& y) {
+            return x.a == y.a && x.b == y.b;
+        }), events.end());
+        return (int)events.size();
+    }
+
+    const vector<Event>& getEvents() const { return events; }
+};
+
+//κλασση που αντιπροσοπευει τον κοσμο της προσομοιωσης
+class GridWorld {
+private:
+    int dimX, dimY;
+    int currentTick;
+    // τα αντικειμενα ζουν σε μια δεξαμενη ανα ειδος, ολα ειναι στη στηλη owner του store
+    ObjectPool pools[6];
+    // τα δεδομενα των οντοτητων σε συνεχομενους πινακες (δες EntityStore)
+    EntityStore store;
+    // ευρετηριο κελιων: για καθε κατειλημενο κελι η αρχη της λιστας των slot του (-1 για τα αδεια), ωστε η
+    // αναζητηση ανα κελι να ειναι O(1). τα tiles του υπαρχουν μονο οπου υπαρχουν οντοτητες, ετσι ο κοσμος
+    // μπορει να ειναι 100000x100000 με μνημη αναλογη των κατειλημενων περιοχων
+    ChunkedGrid<int> cellHead;
+    // τα slot που βγηκαν απο τα ορια στο τελευταιο stepMovers, σε αυξουσα σειρα, και η νεα θεση των
+    // υπολοιπων μετα τη συμπτυξη
+    vector<int> outOfBounds;
+    vector<int> newSlot;
+
+    void linkSlot(int s) {
+        int head = cellHead.get(store.x[s], store.y[s]);
+        store.cellPrev[s] = -1;
+        store.cellNext[s] = head;
+        if (head != -1) store.cellPrev[head] = s;
+        cellHead.set(store.x[s], store.y[s], s);
+    }
+
+    void unlinkSlot(int s) {
+        int prev = store.cellPrev[s];
+        int next = store.cellNext[s];
+        if (prev != -1) {
+            store.cellNext[prev] = next;
+        } else {
+            // αν αδειασει το κελι γινεται -1 και το tile του ελευθερωνεται μολις αδειασει ολο
+            cellHead.set(store.x[s], store.y[s], next);
+        }
+        if (next != -1) store.cellPrev[next] = prev;
+    }
+
+    // μεταφερει την οντοτητα του slot from στο ελευθερο slot to, μαζι με τους δεσμους της στο ευρετηριο
+    void moveSlot(int from, int to) {
+        int prev = store.cellPrev[from];
+        int next = store.cellNext[from];
+        if (prev != -1) store.cellNext[prev] = to;
+        else cellHead.replace(store.x[from], store.y[from], to);
+        if (next != -1) store.cellPrev[next] = to;
+        store.copySlot(from, to);
+        store.owner[to]->slot = to;
+    }
+
+    // βγαζει το slot απο το store μεταφεροντας το τελευταιο slot στη θεση του
+    void removeSlot(int s) {
+        unlinkSlot(s);
+        int last = store.size() - 1;
+        if (s != last) moveSlot(last, s);
+        store.popBack();
+    }
+
+    // καταστρεφει τις οντοτητες του outOfBounds (ηδη εκτος ευρετηριου) και φερνει τις υπολοιπες μπροστα,
+    // κρατωντας τη σειρα τους. μετα διορθωνει τους δεσμους του ευρετηριου προς τα slot που μετακινηθηκαν
+    void compact() {
+        int first = outOfBounds[0];
+        newSlot.resize(store.size());
+        size_t next = 0;
+        for (int s = first, to = first; s < store.size(); s++) {
+            if (next < outOfBounds.size() && outOfBounds[next] == s) {
+                destroy(store.owner[s]);
+                next++;
+            } else {
+                newSlot[s] = to++;
+            }
+        }
+        store.compact(outOfBounds);
+        for (int s = 0; s < store.size(); s++) {
+            if (store.cellNext[s] >= first) store.cellNext[s] = newSlot[store.cellNext[s]];
+            if (store.cellPrev[s] >= first) store.cellPrev[s] = newSlot[store.cellPrev[s]];
+            else if (store.cellPrev[s] == -1 && s >= first) cellHead.replace(store.x[s], store.y[s], s);
+        }
+        for (int s = first; s < store.size(); s++) store.owner[s]->slot = s;
+    }
+
+    void destroy(Object* obj) {
+        Kind kind = obj->getKind();
+        obj->~Object();
+        pools[(int)kind].release(obj);
+    }
+
+public:
+    GridWorld(int x, int y) : dimX(x), dimY(y), currentTick(0), cellHead(-1) {
+        static_assert(ChunkedGrid<int>::SHIFT == LineOfSight::SHIFT, "occupancy words are the cell index tiles");
+        LOG(Lifecycle, Info) << "[+WORLD: GRID] Reticulating splines – Hello, world!\n";
+    }
+
+    ~GridWorld() {
+        for (Object* obj : store.owner) {
+            if (obj) destroy(obj);
+        }
+        LOG(Lifecycle, Info) << "[-WORLD: GRID] Goodbye, cruel world!\n";
+    }
+
+    // δημιουργει αντικειμενο στη δεξαμενη του ειδους του. ανηκει στον κοσμο απο την αρχη και μπαινει
+    // σε αυτον με addObject (ή adoptSlot), οσο μεινει εκτος καταστρεφεται μαζι με τον κοσμο χωρις destructor
+    template <typename T, typename... Args>
+    T* create(Args&&... args) {
+        void* p = pools[(int)T::KIND].allocate(sizeof(T));
+        return new (p) T(forward<Args>(args)...);
+    }
+
+    // δημιουργια αντικειμενου του ειδους kind (οχι SelfDrivingCar), οριζεται μετα τις κλασεις τους
+    Object* create(Kind kind, Position pos);
+
+    template <typename T, typename... Args>
+    T* spawn(Args&&... args) {
+        T* obj = create<T>(forward<Args>(args)...);
+        addObject(obj);
+        return obj;
+    }
+
+    Object* spawn(Kind kind, Position pos) {
+        Object* obj = create(kind, pos);
+        addObject(obj);
+        return obj;
+    }
+
+    // μονο για αντικειμενα απο το create αυτου του κοσμου
+    void addObject(Object* obj) {
+        obj->slot = obj->attach(store);
+        obj->store = &store;
+        linkSlot(obj->slot);
+    }
+
+    // χωρητικοτητα για n οντοτητες, πριν απο μαζικη δημιουργια
+    void reserve(int n) { store.reserve(n); }
+
+    int objectCount() const { return store.size(); }
+    size_t poolBytes() const {
+        size_t bytes = 0;
+        for (const ObjectPool& pool : pools) bytes += pool.memoryBytes();
+        return bytes;
+    }
+
+    const EntityStore& getStore() const { return store; }
+
+    // φορτωση snapshot: οι στηλες του store γεμιζουν απευθειας απο το αρχειο
+    EntityStore& restoreStore() { return store; }
+
+    // δινει στο ηδη γεμισμενο slot s το αντικειμενο του και το βαζει στο ευρετηριο κελιων
+    // (οι λιστες cellNext/cellPrev ηρθαν με το store, λειπει μονο η αρχη καθε κελιου)
+    void adoptSlot(int s, Object* obj) {
+        obj->id.num = handleNum(store.handle[s]);
+        obj->store = &store;
+        obj->slot = s;
+        store.owner[s] = obj;
+        if (store.cellPrev[s] == -1) cellHead.set(store.x[s], store.y[s], s);
     }
     
-    virtual ~RadarSensor() { 
-        cout << "[-SENSOR: " << sensorId << "] Sensor destroyed – No further data from me!" << endl;
+    // ολα τα αντικειμενα ενος κελιου, τα προσθετει στο out
+    void getObjectsAt(int x, int y, vector<Object*>& out) const {
+        for (int s = cellHead.get(x, y); s != -1; s = store.cellNext[s]) {
+            out.push_back(store.owner[s]);
+        }
     }
 
-    vector<SensorReading> scan(const GridWorld& world, int carX, int carY, string carDir) override {
-        vector<SensorReading> results;
-        int range = 12;
+    Object* getObjectAt(int x, int y) const {
+        int head = cellHead.get(x, y);
+        return head != -1 ? store.owner[head] : nullptr;
+    }
 
-        for (auto obj : world.getObjects()) {
-            Position pos = obj->getPosition();
-            int dx = pos.x - carX;
-            int dy = pos.y - carY;
+    // μετακινει την οντοτητα του slot κατα speed προς την κατευθυνση της (ενημερωνει και το ευρετηριο)
+    // επιστρεφει false χωρις να την μετακινησει αν η νεα θεση ειναι εκτος οριων
+    bool moveEntity(int s) {
+        int newX = store.x[s];
+        int newY = store.y[s];
+        int speed = store.speed[s];
+        switch (store.dir[s]) {
+            case Dir::E: newX += speed; break;
+            case Dir::W: newX -= speed; break;
+            case Dir::N: newY += speed; break;
+            case Dir::S: newY -= speed; break;
+            default: break;
+        }
+        if (!inBounds(newX, newY)) return false;
+        if (newX != store.x[s] || newY != store.y[s]) {
+            unlinkSlot(s);
+            store.x[s] = newX;
+            store.y[s] = newY;
+            linkSlot(s);
+        }
+        return true;
+    }
 
-            //τσεκαρω αν το αντικειμενο ειναι μπροστα απο το αυτοκινητο
-            bool inFront = false;
-            int frontDistance = 0;
-            
-            if (carDir == "E" && dx > 0 && abs(dy) <= 1) {
-                inFront = true;
-                frontDistance = dx;
-            } else if (carDir == "W" && dx < 0 && abs(dy) <= 1) {
-                inFront = true;
-                frontDistance = abs(dx);
-            } else if (carDir == "N" && dy > 0 && abs(dx) <= 1) {
-                inFront = true;
-                frontDistance = dy;
-            } else if (carDir == "S" && dy < 0 && abs(dx) <= 1) {
-                inFront = true;
-                frontDistance = abs(dy);
+    // ενα βημα ολων των ποδηλατων και αυτοκινητων κατευθειαν πανω στο store, με βαση μονο τη στηλη kind. οσα
+    // βγαινουν απο τα ορια σημαδευονται και καταστρεφονται ολα μαζι στο τελος (με το μηνυμα του destructor
+    // τους), οι υπολοιπες οντοτητες κρατανε τη σειρα τους. με collisions καταγραφει τη διαδρομη καθε κινουμενου
+    // που εμεινε στον κοσμο. επιστρεφει ποσα βγηκαν
+    int stepMovers(CollisionDetector* collisions = nullptr) {
+        outOfBounds.clear();
+        for (int s = 0; s < store.size(); s++) {
+            if (store.kind[s] != Kind::Bike && store.kind[s] != Kind::Car) continue;
+            Position from(store.x[s], store.y[s]);
+            if (!moveEntity(s)) {
+                unlinkSlot(s);
+                outOfBounds.push_back(s);
+            } else if (collisions) {
+                collisions->add(store.handle[s], from, Position(store.x[s], store.y[s]));
             }
-            
-            //αν ειναι μπροστα και μεσα στο range και κινητο το εντοπιζω
-            if (inFront && frontDistance <= range && obj->getSpeed() > 0) {
-                SensorReading reading;
-                reading.objectType = obj->getType();
-                reading.objectId = obj->getID();
-                reading.position = pos;
-                reading.distance = frontDistance;
-                
-                double baseConfidence = 0.95;
-                double distanceFactor = 1.0 - (reading.distance / (double)range);
-                reading.confidence = baseConfidence * distanceFactor;
-                reading.confidence += ((rand() % 11) - 5) * 0.01;
-                reading.confidence = max(0.0, min(1.0, reading.confidence));
-                
-                reading.speed = obj->getSpeed();
-                reading.direction = obj->getDirection();
-                results.push_back(reading);
+        }
+        if (!outOfBounds.empty()) compact();
+        return (int)outOfBounds.size();
+    }
+
+    // καλει την f(slot) για καθε οντοτητα μεσα στο ορθογωνιο [x0,x1]x[y0,y1] (μαζι με τα ακρα),
+    // κατευθειαν πανω στο ευρετηριο χωρις ενδιαμεσο vector
+    template <typename F>
+    void forEachSlotInRect(int x0, int y0, int x1, int y1, F&& f) const {
+        x0 = max(x0, 0);
+        y0 = max(y0, 0);
+        x1 = min(x1, dimX - 1);
+        y1 = min(y1, dimY - 1);
+        cellHead.forEachInRect(x0, y0, x1, y1, [&](int, int, int head) {
+            for (int s = head; s != -1; s = store.cellNext[s]) f(s);
+        });
+    }
+
+    // λωριδα μπροστα απο το (x,y) προς την κατευθυνση dir: κελια σε αποσταση 1..length μπροστα
+    // και το πολυ halfWidth δεξια/αριστερα (το οπτικο πεδιο της καμερας και του radar)
+    template <typename F>
+    void forEachSlotInStrip(int x, int y, Dir dir, int length, int halfWidth, F&& f) const {
+        if (dir == Dir::E) forEachSlotInRect(x + 1, y - halfWidth, x + length, y + halfWidth, f);
+        else if (dir == Dir::W) forEachSlotInRect(x - length, y - halfWidth, x - 1, y + halfWidth, f);
+        else if (dir == Dir::N) forEachSlotInRect(x - halfWidth, y + 1, x + halfWidth, y + length, f);
+        else if (dir == Dir::S) forEachSlotInRect(x - halfWidth, y - length, x + halfWidth, y - 1, f);
+    }
+
+    // τα κατειλημενα κελια του μπλοκ 8x8 (bx, by) σε μια λεξη, για τη LineOfSight
+    uint64_t occupancyWord(int bx, int by) const { return cellHead.filledBits(bx, by); }
+
+    // οι ιδιες αναζητησεις, τα slot προστιθενται στο out
+    void queryRectSlots(int x0, int y0, int x1, int y1, vector<int>& out) const {
+        forEachSlotInRect(x0, y0, x1, y1, [&](int s) { out.push_back(s); });
+    }
+
+    void queryStripSlots(int x, int y, Dir dir, int length, int halfWidth, vector<int>& out) const {
+        forEachSlotInStrip(x, y, dir, length, halfWidth, [&](int s) { out.push_back(s); });
+    }
+
+    // και με αποτελεσμα τα ιδια τα αντικειμενα
+    void queryRect(int x0, int y0, int x1, int y1, vector<Object*>& out) const {
+        forEachSlotInRect(x0, y0, x1, y1, [&](int s) { out.push_back(store.owner[s]); });
+    }
+
+    void queryStrip(int x, int y, Dir dir, int length, int halfWidth, vector<Object*>& out) const {
+        forEachSlotInStrip(x, y, dir, length, halfWidth, [&](int s) { out.push_back(store.owner[s]); });
+    }
+
+    bool inBounds(int x, int y) const {
+        return x >= 0 && x < dimX && y >= 0 && y < dimY;
+    }
+    
+    int getDimX() const { return dimX; }
+    int getDimY() const { return dimY; }
+    int getTick() const { return currentTick; }
+    
+    //συναρτηση που ενημερωνει ολα τα αντικειμενα. μονο τα φαναρια αλλαζουν μονα τους και η κατασταση τους
+    //βγαινει απο το ρολοι του store, αρα ενα tick δεν περναει απο καμια οντοτητα
+    void updateAll(int tick) {
+        currentTick = tick;
+        store.lightClock = tick + 1;
+    }
+    
+    //συναρτηση για την αφαιρεση αντικειμενων απο τον κοσμο: το slot του το βρισκει κατευθειαν, στη θεση του
+    //ερχεται το τελευταιο slot και η μνημη του γυριζει στη δεξαμενη, ολα σε O(1)
+    void removeObject(Object* obj) {
+        if (obj->store != &store) return;
+        removeSlot(obj->slot);
+        destroy(obj);
+    }
+};
+
+ScanParams Sensor::baseParams(const GridWorld& world, int carX, int carY, float base, float scale) const {
+    ScanParams p;
+    p.carX = carX;
+    p.carY = carY;
+    p.wx = p.wy = 1;
+    p.base = base;
+    p.scale = scale;
+    p.noiseKey = noiseKey;
+    p.tick = (uint32_t)world.getTick();
+    return p;
+}
+
+void LineOfSight::load(const GridWorld& world, int x0, int y0, int x1, int y1) {
+    x0 = max(x0, 0);
+    y0 = max(y0, 0);
+    x1 = min(x1, world.getDimX() - 1);
+    y1 = min(y1, world.getDimY() - 1);
+    words.clear();
+    bw = bh = 0;
+    if (x0 > x1 || y0 > y1) return;
+    bx0 = x0 >> SHIFT;
+    by0 = y0 >> SHIFT;
+    bw = (x1 >> SHIFT) - bx0 + 1;
+    bh = (y1 >> SHIFT) - by0 + 1;
+    for (int by = by0; by < by0 + bh; by++) {
+        for (int bx = bx0; bx < bx0 + bw; bx++) words.push_back(world.occupancyWord(bx, by));
+    }
+}
+
+void Sensor::emitHits(const GridWorld& world, const ScanParams& p, bool movingOnly, bool lineOfSight, vector<SensorReading>& results) {
+    const EntityStore& store = world.getStore();
+    int n = (int)candidates.size();
+    packedX.resize(n);
+    packedY.resize(n);
+    packedHandle.resize(n);
+    for (int i = 0; i < n; i++) {
+        int s = candidates[i];
+        packedX[i] = store.x[s];
+        packedY[i] = store.y[s];
+        packedHandle[i] = store.handle[s];
+    }
+    hitMask.resize((n + 7) / 8);
+    hitConfidence.resize(n);
+    hitDistance.resize(n);
+    ScanKernel::run(p, packedX.data(), packedY.data(), packedHandle.data(), n,
+                    hitMask.data(), hitConfidence.data(), hitDistance.data());
+    // οι ακτινες ξεκινανε απο το κελι του οχηματος, που για την καμερα ειναι εξω απο το κουτι της
+    if (lineOfSight && n > 0) {
+        sight.load(world, min(p.carX, p.carX + p.dxMin), min(p.carY, p.carY + p.dyMin),
+                   max(p.carX, p.carX + p.dxMax), max(p.carY, p.carY + p.dyMax));
+    }
+    // οι candidates ερχονται κελι κελι, οσοι μοιραζονται κελι παιρνουν την ιδια ακτινα
+    Position rayCell(-1, -1);
+    bool rayClear = true;
+
+    for (int i = 0; i < n; i++) {
+        if (!(hitMask[i >> 3] & (1u << (i & 7)))) continue;
+        int s = candidates[i];
+        if (store.handle[s] == owner) continue;
+        if (movingOnly && store.speed[s] <= 0) continue;
+        if (lineOfSight) {
+            if (store.x[s] != rayCell.x || store.y[s] != rayCell.y) {
+                rayCell = Position(store.x[s], store.y[s]);
+                rayClear = sight.clear(p.carX, p.carY, rayCell.x, rayCell.y);
             }
+            if (!rayClear) continue;
         }
+        SensorReading reading;
+        reading.objectType = store.kind[s];
+        reading.objectId = store.handle[s];
+        reading.position = Position(store.x[s], store.y[s]);
+        reading.distance = hitDistance[i];
+        reading.confidence = hitConfidence[i];
+        reading.speed = store.speed[s];
+        reading.direction = store.dir[s];
+        reading.trafficLight = store.light(s);
+        results.push_back(reading);
+    }
+}
+
+//κλάση για αισθητηρα lidar
+class LidarSensor : public Sensor {
+public:
+    LidarSensor(int x, int y) : Sensor("LIDAR", x, y) {
+        LOG(Lifecycle, Info) << "[+LIDAR: " << sensorId << "] Lidar sensor ready – Sensing with pew pews!\n";
+    }
+    
+    virtual ~LidarSensor() { 
+        LOG(Lifecycle, Info) << "[-SENSOR: " << sensorId << "] Sensor destroyed – No further data from me!\n";
+    }
+
+    void scan(const GridWorld& world, int carX, int carY, Dir carDir, vector<SensorReading>& results) override {
+        int range = 4; // 9x9 area
+
+        candidates.clear();
+        world.queryRectSlots(carX - range, carY - range, carX + range, carY + range, candidates);
+
+        // Base confidence 0.99, falling with Manhattan distance. οτι κρυβεται πισω απο αλλο αντικειμενο δεν φαινεται
+        ScanParams p = baseParams(world, carX, carY, 0.99f, (float)(range * 2));
+        p.dxMin = p.dyMin = -range;
+        p.dxMax = p.dyMax = range;
+        emitHits(world, p, false, true, results);
+    }
+};
+
+//κλάση για αισθητηρα radar
+class RadarSensor : public Sensor {
+public:
+    RadarSensor(int x, int y) : Sensor("RADAR", x, y) {
+        LOG(Lifecycle, Info) << "[+RADAR: " << sensorId << "] Radar sensor ready – I'm a Radio star!\n";
+    }
+    
+    virtual ~RadarSensor() { 
+        LOG(Lifecycle, Info) << "[-SENSOR: " << sensorId << "] Sensor destroyed – No further data from me!\n";
+    }
+
+    void scan(const GridWorld& world, int carX, int carY, Dir carDir, vector<SensorReading>& results) override {
+        int range = 12;
+
+        candidates.clear();
+        world.queryStripSlots(carX, carY, carDir, range, 1, candidates);
 
-        return results;
+        //βλεπει μονο οτι ειναι μπροστα απο το αυτοκινητο, η αποσταση ειναι αυτη κατα τη φορα του
+        ScanParams p = baseParams(world, carX, carY, 0.95f, (float)range);
+        frontBox(carDir, range, 1, p);
+        bool horizontal = carDir == Dir::E || carDir == Dir::W;
+        p.wx = horizontal ? 1 : 0;
+        p.wy = horizontal ? 0 : 1;
+        //και μονο τα κινητα, το κυμα του περναει και πισω απο οτι βρει μπροστα του
+        emitHits(world, p, true, false, results);
     }
 };
 
@@ -311,60 +1763,31 @@ public:
 class CameraSensor : public Sensor {
 public:
     CameraSensor(int x, int y) : Sensor("CAMERA", x, y) {
-        cout << "[+CAMERA: " << sensorId << "] Camera sensor ready – Say cheese!" << endl;
+        LOG(Lifecycle, Info) << "[+CAMERA: " << sensorId << "] Camera sensor ready – Say cheese!\n";
     }
     
     virtual ~CameraSensor() { 
-        cout << "[-SENSOR: " << sensorId << "] Sensor destroyed – No further data from me!" << endl;
+        LOG(Lifecycle, Info) << "[-SENSOR: " << sensorId << "] Sensor destroyed – No further data from me!\n";
     }
 
-    vector<SensorReading> scan(const GridWorld& world, int carX, int carY, string carDir) override {
-        vector<SensorReading> results;
+    void scan(const GridWorld& world, int carX, int carY, Dir carDir, vector<SensorReading>& results) override {
         int range = 3; // 7x7 area in front
 
-        for (auto obj : world.getObjects()) {
-            Position pos = obj->getPosition();
-            int dx = pos.x - carX;
-            int dy = pos.y - carY;
-            
-            //τσεκαρω αν το αντικειμενο ειναι μπροστα απο το αυτοκινητο
-            bool inView = false;
-            if (carDir == "E" && dx > 0 && dx <= range && abs(dy) <= range) inView = true;
-            else if (carDir == "W" && dx < 0 && abs(dx) <= range && abs(dy) <= range) inView = true;
-            else if (carDir == "N" && dy > 0 && dy <= range && abs(dx) <= range) inView = true;
-            else if (carDir == "S" && dy < 0 && abs(dy) <= range && abs(dx) <= range) inView = true;
-
-            //αν ειναι μπροστα και μεσα στο range το εντοπιζω
-            if (inView) {
-                SensorReading reading;
-                reading.objectType = obj->getType();
-                reading.objectId = obj->getID();
-                reading.position = pos;
-                reading.distance = abs(dx) + abs(dy);
-                
-                double baseConfidence = 0.87;
-                double distanceFactor = 1.0 - (reading.distance / (double)(range * 2));
-                reading.confidence = baseConfidence * distanceFactor;
-                reading.confidence += ((rand() % 11) - 5) * 0.01;
-                reading.confidence = max(0.0, min(1.0, reading.confidence));
-                
-                reading.speed = obj->getSpeed();
-                reading.direction = obj->getDirection();
-                reading.signText = obj->getSignText();
-                reading.trafficLight = obj->getTrafficLight();
-                results.push_back(reading);
-            }
-        }
+        candidates.clear();
+        world.queryStripSlots(carX, carY, carDir, range, range, candidates);
 
-        return results;
+        //οτι ειναι μπροστα απο το αυτοκινητο, μεσα στο range και σε οπτικη επαφη
+        ScanParams p = baseParams(world, carX, carY, 0.87f, (float)(range * 2));
+        frontBox(carDir, range, range, p);
+        emitHits(world, p, false, true, results);
     }
 };
 
 //βασικη κλαση για κινητα αντικειμενα
 class StaticObject : public Object {
 public:
-    StaticObject(string type, int num, string glyph, Position pos) 
-        : Object(type, num, glyph, pos) {
+    StaticObject(Kind kind, int num, char glyph, Position pos) 
+        : Object(kind, num, glyph, pos) {
     }
     
     ~StaticObject() {}
@@ -373,96 +1796,112 @@ public:
 //κλάση για παρκαρισμενα αυτοκινητα
 class ParkedCar : public StaticObject {
 public:
+    static const Kind KIND = Kind::ParkedCar;
+
     ParkedCar(Position pos) 
-        : StaticObject("ParkedCar", Object::getNextId("ParkedCar"), "P", pos) {
-        cout << "[+PARKED: " << getID() << "] Parked at (" << pos.x << "," << pos.y << ")" << endl;
+        : StaticObject(Kind::ParkedCar, Object::getNextId(Kind::ParkedCar), 'P', pos) {
+        LOG(Lifecycle, Info) << "[+PARKED: " << getID() << "] Parked at (" << pos.x << "," << pos.y << ")\n";
     }
     
     ~ParkedCar() {
-        cout << "[-PARKED: " << getID() << "] I'm being towed away!" << endl;
+        LOG(Lifecycle, Info) << "[-PARKED: " << getID() << "] I'm being towed away!\n";
     }
     
+    Kind getKind() const override { return KIND; }
     string getType() const override { return "ParkedCar"; }
 };
 
 class StopSign : public StaticObject {
 public:
+    static const Kind KIND = Kind::StopSign;
+
     StopSign(Position pos) 
-        : StaticObject("StopSign", Object::getNextId("StopSign"), "S", pos) {
+        : StaticObject(Kind::StopSign, Object::getNextId(Kind::StopSign), 'S', pos) {
     }
     
     ~StopSign() {}
     
+    Kind getKind() const override { return KIND; }
     string getType() const override { return "StopSign"; }
     string getSignText() const override { return "STOP"; }
 };
 
 class TrafficLight : public StaticObject {
 private:
-    string state;
-    int tickCounter;
+    int phase;
+    int clock;   // ticks του φαναριου οσο δεν ειναι στον κοσμο
 public:
+    static const Kind KIND = Kind::TrafficLight;
+
+    // ξεκιναει κοκκινο με τυχαιο μετρητη 0-13. μετρητης πανω απο 3 σημαινει οτι γινεται πρασινο στο πρωτο
+    // tick, δηλαδη ιδιος κυκλος με τη θεση 3
     TrafficLight(Position pos) 
-        : StaticObject("TrafficLight", Object::getNextId("TrafficLight"), "R", pos), 
-          state("RED"), tickCounter(rand() % 14) { // Random starting point in cycle
-        cout << "[+LIGHT: " << getID() << "] Initialized at (" << pos.x << "," << pos.y << ") to " << state << endl;
+        : StaticObject(Kind::TrafficLight, Object::getNextId(Kind::TrafficLight), 'R', pos), 
+          phase(min(3, (int)Rng::below(Rng::key(Rng::LightPhase, getHandle()), 0, LIGHT_CYCLE))), clock(0) {
+        LOG(Lifecycle, Info) << "[+LIGHT: " << getID() << "] Initialized at (" << pos.x << "," << pos.y << ") to " << lightName(getLight()) << "\n";
     }
     
     ~TrafficLight() {
-        cout << "[-LIGHT: " << getID() << "] Turning off" << endl;
+        LOG(Lifecycle, Info) << "[-LIGHT: " << getID() << "] Turning off\n";
     }
     
+    int attach(EntityStore& s) override {
+        return s.add(this, getKind(), getHandle(), position, 0, Dir::None, phase);
+    }
+
+    Light getLight() const { return store ? store->light(slot) : lightAt(phase, clock); }
+
+    Kind getKind() const override { return KIND; }
     string getType() const override { return "TrafficLight"; }
-    string getTrafficLight() const override { return state; }
-    string getGlyph() const override { 
-        if (state == "RED") return "R";
-        if (state == "YELLOW") return "Y";
-        if (state == "GREEN") return "G";
-        return "?";
+    Light getTrafficLight() const override { return getLight(); }
+    char getGlyph() const override { 
+        return lightGlyph(getLight());
     }
     
     void update(int tick) override {
-        tickCounter++;
-        // κυκλοι φαναριου : κοκκινο -> 4 ticks - πρασινο -> 8 ticks - κιτρινο -> 2 ticks
-        if (state == "RED" && tickCounter >= 4) {
-            state = "GREEN";
-            tickCounter = 0;
-        } else if (state == "GREEN" && tickCounter >= 8) {
-            state = "YELLOW";
-            tickCounter = 0;
-        } else if (state == "YELLOW" && tickCounter >= 2) {
-            state = "RED";
-            tickCounter = 0;
-        }
+        if (!store) clock++;
     }
 };
 
 class MovingObject : public Object { 
 protected:
     int speed;
-    string direction;
+    Dir direction;
 public:
-    MovingObject(string type, int num, string glyph, Position pos, 
-                int Speed = 0, string Direction = "") 
-        : Object(type, num, glyph, pos), speed(Speed), direction(Direction) {
+    MovingObject(Kind kind, int num, char glyph, Position pos, 
+                int Speed = 0, Dir Direction = Dir::None) 
+        : Object(kind, num, glyph, pos), speed(Speed), direction(Direction) {
     }
     
     ~MovingObject() {}
     
-    int getSpeed() const override { return speed; }
-    string getDirection() const override { return direction; }
+    int attach(EntityStore& s) override {
+        return s.add(this, getKind(), getHandle(), position, speed, direction, 0);
+    }
+
+    int getSpeed() const override { return store ? store->speed[slot] : speed; }
+    Dir getDirection() const override { return store ? store->dir[slot] : direction; }
     
-    void setSpeed(int s) { speed = s; }
-    void setDirection(const string& dir) { direction = dir; }
+    void setSpeed(int s) {
+        speed = s;
+        if (store) store->speed[slot] = s;
+    }
+    void setDirection(Dir dir) {
+        direction = dir;
+        if (store) store->dir[slot] = dir;
+    }
     
     virtual bool move(GridWorld& world) {
+        // μεσα στον κοσμο η κινηση γινεται πανω στο store ωστε να ενημερωθει και το ευρετηριο κελιων
+        if (store) return world.moveEntity(slot);
+
         int newX = position.x;
         int newY = position.y;
         
-        if (direction == "E") newX += speed;
-        else if (direction == "W") newX -= speed;
-        else if (direction == "N") newY += speed;
-        else if (direction == "S") newY -= speed;
+        if (direction == Dir::E) newX += speed;
+        else if (direction == Dir::W) newX -= speed;
+        else if (direction == Dir::N) newY += speed;
+        else if (direction == Dir::S) newY -= speed;
         
         if (world.inBounds(newX, newY)) {
             position.x = newX;
@@ -478,112 +1917,766 @@ public:
 
 class Bike : public MovingObject {
 public:
+    static const Kind KIND = Kind::Bike;
+
     Bike(Position pos) 
-        : MovingObject("Bike", Object::getNextId("Bike"), "B", pos, 1, "N") {
-        // χρησημοποιω το rand() για να εχει τυχαι αρχικη κατευθηνση το ποδηλατο
-        vector<string> dirs = {"N", "S", "E", "W"};
-        direction = dirs[rand() % 4];
-        cout << "[+BIKE: " << getID() << "] Created at (" << pos.x << "," << pos.y 
-             << "), heading " << direction << " at " << speed << " units/tick" << endl;
+        : MovingObject(Kind::Bike, Object::getNextId(Kind::Bike), 'B', pos, 1, Dir::N) {
+        // τυχαια αρχικη κατευθηνση για το ποδηλατο απο τη δικη του ροη
+        static const Dir dirs[] = {Dir::N, Dir::S, Dir::E, Dir::W};
+        direction = dirs[Rng::below(Rng::key(Rng::Direction, getHandle()), 0, 4)];
+        LOG(Lifecycle, Info) << "[+BIKE: " << getID() << "] Created at (" << pos.x << "," << pos.y 
+             << "), heading " << dirName(direction) << " at " << speed << " units/tick\n";
     }
     
     ~Bike() {
-        cout << "[-BIKE: " << getID() << "] Being locked away..." << endl;
+        LOG(Lifecycle, Info) << "[-BIKE: " << getID() << "] Being locked away...\n";
     }
     
+    Kind getKind() const override { return KIND; }
     string getType() const override { return "Bike"; }
 };
 
 class OtherCar : public MovingObject {
 public:
+    static const Kind KIND = Kind::Car;
+
     OtherCar(Position pos) 
-        : MovingObject("Car", Object::getNextId("Car"), "C", pos, 1, "N") {
-        // χρησημοποιω το rand() για να εχει τυχαια αρχικη κατευθηνση το κινημενο αυτοκινητο
-        vector<string> dirs = {"N", "S", "E", "W"};
-        direction = dirs[rand() % 4];
-        cout << "[+CAR: " << getID() << "] Initialized at (" << pos.x << "," << pos.y 
-             << ") facing " << direction << " – No driver's license required!" << endl;
+        : MovingObject(Kind::Car, Object::getNextId(Kind::Car), 'C', pos, 1, Dir::N) {
+        // τυχαια αρχικη κατευθηνση για το κινουμενο αυτοκινητο απο τη δικη του ροη
+        static const Dir dirs[] = {Dir::N, Dir::S, Dir::E, Dir::W};
+        direction = dirs[Rng::below(Rng::key(Rng::Direction, getHandle()), 0, 4)];
+        LOG(Lifecycle, Info) << "[+CAR: " << getID() << "] Initialized at (" << pos.x << "," << pos.y 
+             << ") facing " << dirName(direction) << " – No driver's license required!\n";
     }
     
     ~OtherCar() {
-        cout << "[-CAR: " << getID() << "] Our journey is complete!" << endl;
+        LOG(Lifecycle, Info) << "[-CAR: " << getID() << "] Our journey is complete!\n";
     }
     
+    Kind getKind() const override { return KIND; }
     string getType() const override { return "Car"; }
 };
 
-class SensorFusionEngine {
+//δημιουργει αντικειμενο του ειδους kind (οχι SelfDrivingCar) εκτος κοσμου, στο heap
+Object* make_object(Kind kind, Position pos) {
+    switch (kind) {
+        case Kind::Bike: return new Bike(pos);
+        case Kind::Car: return new OtherCar(pos);
+        case Kind::ParkedCar: return new ParkedCar(pos);
+        case Kind::StopSign: return new StopSign(pos);
+        default: return new TrafficLight(pos);
+    }
+}
+
+Object* GridWorld::create(Kind kind, Position pos) {
+    switch (kind) {
+        case Kind::Bike: return create<Bike>(pos);
+        case Kind::Car: return create<OtherCar>(pos);
+        case Kind::ParkedCar: return create<ParkedCar>(pos);
+        case Kind::StopSign: return create<StopSign>(pos);
+        default: return create<TrafficLight>(pos);
+    }
+}
+
+//αρχειο που διαβαζεται ολοκληρο απο τη μνημη μεσω mmap, χωρις αντιγραφη σε buffer
+class MappedFile {
 private:
-    double minConfidenceThreshold;
-    
+    void* mapping;
+    size_t length;
+
 public:
-    SensorFusionEngine(double threshold = 0.4) : minConfidenceThreshold(threshold) {}
-    
-    vector<SensorReading> fuseSensorData(const vector<SensorReading>& allReadings) {
-        map<string, vector<SensorReading>> readingsByObject;
-        vector<SensorReading> fusedResults;
-        
-        for (const auto& reading : allReadings) {
-            readingsByObject[reading.objectId].push_back(reading);
-        }
-        
-        for (const auto& pair : readingsByObject) {
-            const vector<SensorReading>& readings = pair.second;
-            
-            if (readings.empty()) continue;
-            
-            SensorReading fused = readings[0];
-            double totalConfidence = 0.0;
-            int count = 0;
-            
-            // εννονω τα δεδομενα για το ιδιο αντικειμενο
-            for (const auto& r : readings) {
-                totalConfidence += r.confidence;
-                count++;
-                
-            
-                if (r.confidence > fused.confidence) {
-                    if (!r.trafficLight.empty()) fused.trafficLight = r.trafficLight;
-                    if (!r.signText.empty()) fused.signText = r.signText;
-                    if (r.speed > 0) {
-                        fused.speed = r.speed;
-                        fused.direction = r.direction;
-                    }
-                }
-            }
-            
-            fused.confidence = totalConfidence / count;
-            
-            bool isBike = readings[0].objectType == "Bike";
-            if (fused.confidence >= minConfidenceThreshold || isBike) {
-                fusedResults.push_back(fused);
-            }
+    MappedFile() : mapping(nullptr), length(0) {}
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+        if (mapping) munmap(mapping, length);
+    }
+
+    bool open(const string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size == 0) {
+            close(fd);
+            return false;
         }
-        
-        return fusedResults;
+        length = (size_t)info.st_size;
+        void* p = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (p == MAP_FAILED) return false;
+        mapping = p;
+        return true;
     }
+
+    const char* data() const { return (const char*)mapping; }
+    size_t size() const { return length; }
 };
 
-class NavigationSystem {
+//γραφει τα δεδομενα ενος snapshot σειριακα (με το buffer του ofstream). καθε πινακας ξεκιναει σε θεση
+//πολλαπλασιο του 8 με το μηκος του μπροστα, ετσι απο το mmap διαβαζεται κατευθειαν χωρις αποκωδικοποιηση
+class SnapshotWriter {
 private:
-    vector<Position> gpsTargets;
-    int currentTargetIndex;
-    SensorFusionEngine fusionEngine;
-    
+    ofstream out;
+    size_t offset;
+
+    void write(const void* p, size_t n) {
+        out.write((const char*)p, n);
+        offset += n;
+    }
+
+    void align() {
+        static const char zeros[8] = {};
+        write(zeros, (8 - offset % 8) % 8);
+    }
+
 public:
-    NavigationSystem(double confidenceThreshold = 0.4) 
-        : currentTargetIndex(0), fusionEngine(confidenceThreshold) {
-        cout << "[+NAV: GPS] Hello, I'll be your GPS today" << endl;
+    SnapshotWriter() : offset(0) {}
+
+    bool open(const string& path) {
+        out.open(path, ios::binary | ios::trunc);
+        return (bool)out;
     }
-    
-    ~NavigationSystem() {
-        cout << "[-NAV: GPS] You've arrived! Shutting down..." << endl;
+
+    template <typename T>
+    void pod(const T& value) {
+        static_assert(is_trivially_copyable<T>::value, "snapshot fields must be trivially copyable");
+        write(&value, sizeof(T));
     }
-    
-    void setGPSTargets(const vector<Position>& targets) {
+
+    template <typename T>
+    void array(const T* data, size_t n) {
+        static_assert(is_trivially_copyable<T>::value, "snapshot arrays must be trivially copyable");
+        align();
+        pod((uint64_t)n);
+        write(data, n * sizeof(T));
+    }
+
+    template <typename T>
+    void array(const vector<T>& v) { array(v.data(), v.size()); }
+
+    void str(const string& text) { array(text.data(), text.size()); }
+
+    // bytes χωρις μηκος και ευθυγραμμιση, για εγγραφες με δικη τους κωδικοποιηση
+    void bytes(const void* p, size_t n) { write(p, n); }
+
+    size_t tell() const { return offset; }
+
+    bool finish() {
+        out.flush();
+        return (bool)out;
+    }
+};
+
+//διαβαζει οτι εγραψε ο SnapshotWriter απο τη μνημη. σε κομμενο αρχειο σταματαει και το good() γινεται false
+class SnapshotReader {
+private:
+    const char* data;
+    size_t size;
+    size_t offset;
+    bool ok;
+
+    bool take(size_t n) {
+        if (!ok || n > size - offset) {
+            ok = false;
+            return false;
+        }
+        offset += n;
+        return true;
+    }
+
+public:
+    SnapshotReader(const char* d, size_t n) : data(d), size(n), offset(0), ok(true) {}
+
+    template <typename T>
+    bool pod(T& value) {
+        size_t at = offset;
+        if (!take(sizeof(T))) return false;
+        memcpy(&value, data + at, sizeof(T));
+        return true;
+    }
+
+    // ο πινακας μενει στη μνημη του αρχειου, επιστρεφει δεικτη σε αυτον (nullptr αν το αρχειο κοβεται)
+    template <typename T>
+    const T* array(size_t& n) {
+        if (!take((8 - offset % 8) % 8)) return nullptr;
+        uint64_t count;
+        if (!pod(count) || count > (size - offset) / sizeof(T)) {
+            ok = false;
+            return nullptr;
+        }
+        n = (size_t)count;
+        const T* p = (const T*)(data + offset);
+        offset += n * sizeof(T);
+        return p;
+    }
+
+    template <typename T>
+    bool array(vector<T>& v) {
+        size_t n = 0;
+        const T* p = array<T>(n);
+        if (!p) return false;
+        v.assign(p, p + n);
+        return true;
+    }
+
+    bool str(string& text) {
+        size_t n = 0;
+        const char* p = array<char>(n);
+        if (!p) return false;
+        text.assign(p, n);
+        return true;
+    }
+
+    bool seek(size_t at) {
+        if (at > size) ok = false;
+        else offset = at;
+        return ok;
+    }
+
+    bool good() const { return ok; }
+};
+
+//ενα αντικειμενο που παρακολουθειται απο tick σε tick
+//(τα πεδια ειναι σε σειρα χωρις κενα ευθυγραμμισης, ετσι το snapshot γραφει μονο ορισμενα bytes)
+struct Track {
+    double confidenceSum;    // αθροισμα εμπιστοσυνης των αναγνωσεων της τρεχουσας σαρωσης
+    SensorReading reading;   // η τελευταια συγχωνευμενη αναγνωση του
+    float x, y;              // φιλτραρισμενη θεση
+    float vx, vy;            // εκτιμηση ταχυτητας σε κελια ανα tick
+    float confidence;        // φιλτραρισμενη εμπιστοσυνη
+    int lastSeen;            // το tick της τελευταιας παρατηρησης
+    int misses;              // συνεχομενες σαρωσεις που δεν το ειδαν
+    int count;               // αναγνωσεις της τρεχουσας σαρωσης
+};
+static_assert(sizeof(Track) == sizeof(double) + sizeof(SensorReading) + 5 * sizeof(float) + 3 * sizeof(int),
+              "Track must not contain padding");
+
+//κραταει πινακα απο tracks με κλειδι το handle και τον ενημερωνει σε καθε σαρωση με ενα φιλτρο alpha-beta
+//για τη θεση/ταχυτητα και εκθετικο μεσο ορο για την εμπιστοσυνη. αναμεσα στις σαρωσεις προβλεπει που
+//βρισκονται τα κινουμενα, ετσι οι αισθητηρες μπορουν να τρεχουν πιο αραια χωρις να χανονται οι κινδυνοι
+class SensorFusionEngine {
+private:
+    double minConfidenceThreshold;
+    vector<Track> tracks;
+    CellMap trackIndex;       // handle -> θεση στο tracks
+    vector<int> order;        // τα tracks ταξινομημενα κατα handle για την εξοδο
+
+    static constexpr float POSITION_GAIN = 0.8f;    // alpha
+    static constexpr float VELOCITY_GAIN = 0.4f;    // beta
+    static constexpr float CONFIDENCE_GAIN = 0.5f;
+    static constexpr float CONFIDENCE_DECAY = 0.85f; // ανα tick χωρις παρατηρηση
+    static constexpr int MAX_MISSES = 1;             // σαρωσεις χωρις παρατηρηση πριν σβησει το track
+
+    static void velocityOf(const SensorReading& r, float& vx, float& vy) {
+        vx = vy = 0;
+        if (r.direction == Dir::E) vx = r.speed;
+        else if (r.direction == Dir::W) vx = -r.speed;
+        else if (r.direction == Dir::N) vy = r.speed;
+        else if (r.direction == Dir::S) vy = -r.speed;
+    }
+
+    bool passes(const Track& t, float confidence) const {
+        return confidence >= minConfidenceThreshold || t.reading.objectType == Kind::Bike;
+    }
+
+    void removeTrack(int i) {
+        trackIndex.erase(tracks[i].reading.objectId);
+        int last = (int)tracks.size() - 1;
+        if (i != last) {
+            tracks[i] = tracks[last];
+            trackIndex.set(tracks[i].reading.objectId, i);
+        }
+        tracks.pop_back();
+    }
+
+    void sortByHandle() {
+        order.resize(tracks.size());
+        for (int i = 0; i < (int)order.size(); i++) order[i] = i;
+        sort(order.begin(), order.end(), [&](int a, int b) {
+            return tracks[a].reading.objectId < tracks[b].reading.objectId;
+        });
+    }
+    
+public:
+    SensorFusionEngine(double threshold = 0.4) : minConfidenceThreshold(threshold) {
+        // αρκετα tracks για πυκνη κινηση απο την αρχη, ωστε να μη μεγαλωνουν στη διαρκεια της προσομοιωσης
+        tracks.reserve(64);
+        order.reserve(64);
+        trackIndex.reserve(64);
+    }
+    
+    // ενημερωνει τα tracks με τις αναγνωσεις μιας σαρωσης και γραφει στο fusedResults οσα ειδε η σαρωση
+    // (ταξινομημενα κατα handle, με τη φιλτραρισμενη εμπιστοσυνη). το fusedResults ανηκει στον καλουντα
+    // και κραταει τη χωρητικοτητα του απο tick σε tick
+    void fuseSensorData(const vector<SensorReading>& allReadings, int tick, vector<SensorReading>& fusedResults) {
+        fusedResults.clear();
+
+        // εννονω τα δεδομενα για το ιδιο αντικειμενο: η πρωτη αναγνωση δινει τη βαση και οσες
+        // ειναι πιο σιγουρες απο αυτη δινουν φαναρι και κινηση
+        for (const auto& r : allReadings) {
+            int* slot = trackIndex.find(r.objectId);
+            if (!slot) {
+                Track t;
+                t.reading = r;
+                t.x = (float)r.position.x;
+                t.y = (float)r.position.y;
+                velocityOf(r, t.vx, t.vy);
+                t.confidence = -1; // νεο track, η πρωτη μετρηση περναει αυτουσια
+                t.lastSeen = tick;
+                t.misses = 0;
+                t.confidenceSum = 0;
+                t.count = 0;
+                trackIndex.set(r.objectId, (int)tracks.size());
+                tracks.push_back(t);
+                slot = trackIndex.find(r.objectId);
+            }
+            Track& t = tracks[*slot];
+            if (t.count == 0) {
+                t.reading.position = r.position;
+                t.reading.distance = r.distance;
+                t.reading.confidence = r.confidence;
+                t.reading.speed = r.speed;
+                t.reading.direction = r.direction;
+                t.reading.trafficLight = r.trafficLight;
+            } else if (r.confidence > t.reading.confidence) {
+                if (r.trafficLight != Light::None) t.reading.trafficLight = r.trafficLight;
+                if (r.speed > 0) {
+                    t.reading.speed = r.speed;
+                    t.reading.direction = r.direction;
+                }
+            }
+            t.confidenceSum += r.confidence;
+            t.count++;
+        }
+
+        for (int i = (int)tracks.size() - 1; i >= 0; i--) {
+            Track& t = tracks[i];
+            if (t.count == 0) {
+                if (++t.misses > MAX_MISSES) removeTrack(i);
+                continue;
+            }
+            float measured = (float)(t.confidenceSum / t.count);
+            if (t.confidence < 0) {
+                t.confidence = measured;
+            } else {
+                // alpha-beta: διορθωνω την προβλεψη με το υπολοιπο της μετρησης
+                float dt = (float)max(1, tick - t.lastSeen);
+                float rx = t.reading.position.x - (t.x + t.vx * dt);
+                float ry = t.reading.position.y - (t.y + t.vy * dt);
+                t.x += t.vx * dt + POSITION_GAIN * rx;
+                t.y += t.vy * dt + POSITION_GAIN * ry;
+                t.vx += VELOCITY_GAIN * rx / dt;
+                t.vy += VELOCITY_GAIN * ry / dt;
+                t.confidence += CONFIDENCE_GAIN * (measured - t.confidence);
+            }
+            t.reading.confidence = t.confidence;
+            t.lastSeen = tick;
+            t.misses = 0;
+            t.confidenceSum = 0;
+            t.count = 0;
+        }
+
+        sortByHandle();
+        for (int i : order) {
+            const Track& t = tracks[i];
+            if (t.lastSeen == tick && passes(t, t.confidence)) fusedResults.push_back(t.reading);
+        }
+    }
+
+    // προσθετει στο out τα tracks που δεν ειδε η σαρωση του tick, στη θεση που προβλεπεται οτι ειναι τωρα
+    // και με εμπιστοσυνη που πεφτει οσο περναει ο χρονος
+    void predictTracks(const Position& carPos, int tick, vector<SensorReading>& out) {
+        sortByHandle();
+        for (int i : order) {
+            const Track& t = tracks[i];
+            if (t.lastSeen >= tick) continue;
+            int dt = tick - t.lastSeen;
+            float confidence = t.confidence * pow(CONFIDENCE_DECAY, (float)dt);
+            if (!passes(t, confidence)) continue;
+            SensorReading predicted = t.reading;
+            predicted.position = Position((int)lround(t.x + t.vx * dt), (int)lround(t.y + t.vy * dt));
+            predicted.distance = carPos.distanceTo(predicted.position);
+            predicted.confidence = confidence;
+            out.push_back(predicted);
+        }
+    }
+
+    int trackCount() const { return (int)tracks.size(); }
+
+    // μονο τα tracks περνανε απο tick σε tick, το ευρετηριο ξαναχτιζεται απο αυτα
+    void save(SnapshotWriter& w) const { w.array(tracks); }
+
+    bool load(SnapshotReader& r) {
+        if (!r.array(tracks)) return false;
+        trackIndex = CellMap();
+        for (int i = 0; i < (int)tracks.size(); i++) trackIndex.set(tracks[i].reading.objectId, i);
+        return true;
+    }
+};
+
+//σχεδιαστης διαδρομης πανω στο πλεγμα του κοσμου με D* Lite: ψαχνει απο τον στοχο προς το οχημα, ετσι οταν
+//κινειται το οχημα ή εμφανιζονται νεα εμποδια (παρκαρισμενα αυτοκινητα απο τους αισθητηρες) διορθωνει μονο
+//οσα κελια επηρεαζονται αντι να ξαναψαχνει απο την αρχη. το g καθε κελιου ειναι η αποσταση του απο τον στοχο
+class PathPlanner {
+public:
+    struct Stats {
+        long long expansions = 0;   // κελια που επεξεργαστηκε
+        int plans = 0;              // πληρεις αναζητησεις (νεος στοχος)
+        int replans = 0;            // διορθωσεις λογω νεων εμποδιων
+        int budgetHits = 0;         // ticks που τελειωσε ο προυπολογισμος πριν βρεθει διαδρομη
+    };
+
+private:
+    static constexpr int INF = 1 << 29;
+
+    struct Entry {
+        int k1, k2;
+        long long cell;
+        bool operator>(const Entry& o) const {
+            if (k1 != o.k1) return k1 > o.k1;
+            if (k2 != o.k2) return k2 > o.k2;
+            return cell > o.cell;
+        }
+    };
+
+    // η κατασταση ενος κελιου για την τρεχουσα αναζητηση
+    struct Node {
+        int g = INF, rhs = INF;
+        int openK1 = 0, openK2 = 0;   // το κλειδι της ισχυουσας εγγραφης του στην ουρα
+        bool inOpen = false;
+        bool operator==(const Node& o) const {
+            return g == o.g && rhs == o.rhs && openK1 == o.openK1 && openK2 == o.openK2 && inOpen == o.inOpen;
+        }
+    };
+
+    struct NodeRecord {
+        int x, y, g, rhs, openK1, openK2, inOpen;
+    };
+
+    // τα κελια ειναι y * dimX + x σε long long ωστε να χωρανε και κοσμοι 100000x100000. η κατασταση
+    // κρατιεται σε tiles μονο για οσα κελια αγγιξε η αναζητηση, οχι για ολο τον κοσμο
+    int dimX, dimY;
+    ChunkedGrid<Node> nodes;
+    ChunkedGrid<char> blocked;
+    // η ουρα κραταει και παλιες εγγραφες, ισχυει μονο αυτη που ταιριαζει με το openK1/openK2 του κελιου
+    priority_queue<Entry, vector<Entry>, greater<Entry>> open;
+    long long start, lastStart, goal;
+    int km;
+    bool consistent;   // η τελευταια αναζητηση ολοκληρωθηκε για τα τωρινα εμποδια και θεση
+    bool changed;      // μπηκαν νεα εμποδια απο την τελευταια αναζητηση
+    Stats stats;
+
+    long long cellOf(const Position& p) const { return (long long)p.y * dimX + p.x; }
+    int xOf(long long cell) const { return (int)(cell % dimX); }
+    int yOf(long long cell) const { return (int)(cell / dimX); }
+    bool inside(const Position& p) const { return p.x >= 0 && p.x < dimX && p.y >= 0 && p.y < dimY; }
+
+    Node& node(long long cell) { return nodes.at(xOf(cell), yOf(cell)); }
+    const Node& peek(long long cell) { return nodes.peek(xOf(cell), yOf(cell)); }
+    int g(long long cell) { return peek(cell).g; }
+    int rhs(long long cell) { return peek(cell).rhs; }
+
+    int heuristic(long long a, long long b) const {
+        return abs(xOf(a) - xOf(b)) + abs(yOf(a) - yOf(b));
+    }
+
+    // κοστος για να μπει κανεις στο κελι (ο στοχος δεν μπλοκαρεται ποτε)
+    int cost(long long to) const { return to != goal && blocked.get(xOf(to), yOf(to)) ? INF : 1; }
+
+    static int add(int a, int b) { return (a >= INF || b >= INF) ? INF : a + b; }
+
+    // οι γειτονες ενος κελιου με τη σειρα E, W, N, S, στο out, επιστρεφει ποσοι ειναι
+    int neighbors(long long cell, long long out[4]) const {
+        int x = xOf(cell), y = yOf(cell), n = 0;
+        if (x + 1 < dimX) out[n++] = cell + 1;
+        if (x > 0) out[n++] = cell - 1;
+        if (y + 1 < dimY) out[n++] = cell + dimX;
+        if (y > 0) out[n++] = cell - dimX;
+        return n;
+    }
+
+    int bestSuccessor(long long cell) {
+        long long around[4];
+        int n = neighbors(cell, around);
+        int best = INF;
+        for (int i = 0; i < n; i++) best = min(best, add(cost(around[i]), g(around[i])));
+        return best;
+    }
+
+    void calculateKey(long long cell, int& k1, int& k2) {
+        const Node& v = peek(cell);
+        int m = min(v.g, v.rhs);
+        k1 = add(add(m, heuristic(start, cell)), km);
+        k2 = m;
+    }
+
+    void updateVertex(long long cell) {
+        Node& v = node(cell);
+        if (v.g != v.rhs) {
+            calculateKey(cell, v.openK1, v.openK2);
+            v.inOpen = true;
+            open.push({v.openK1, v.openK2, cell});
+        } else {
+            v.inOpen = false;
+        }
+    }
+
+    // πεταει τις παλιες εγγραφες απο την κορυφη της ουρας
+    bool topEntry(Entry& top) {
+        while (!open.empty()) {
+            top = open.top();
+            const Node& v = peek(top.cell);
+            if (v.inOpen && v.openK1 == top.k1 && v.openK2 == top.k2) return true;
+            open.pop();
+        }
+        return false;
+    }
+
+    // συνεχιζει την αναζητηση για το πολυ budget κελια, επιστρεφει true αν ολοκληρωθηκε
+    bool computeShortestPath(int budget) {
+        Entry top;
+        while (topEntry(top)) {
+            int sk1, sk2;
+            calculateKey(start, sk1, sk2);
+            bool before = top.k1 < sk1 || (top.k1 == sk1 && top.k2 < sk2);
+            if (!before && rhs(start) <= g(start)) return true;
+            if (budget-- <= 0) return false;
+            stats.expansions++;
+
+            long long u = top.cell;
+            int k1, k2;
+            calculateKey(u, k1, k2);
+            long long around[4];
+            int n = neighbors(u, around);
+            if (top.k1 < k1 || (top.k1 == k1 && top.k2 < k2)) {
+                updateVertex(u);
+            } else if (g(u) > rhs(u)) {
+                Node& v = node(u);
+                v.g = v.rhs;
+                v.inOpen = false;
+                int through = add(cost(u), v.g);
+                for (int i = 0; i < n; i++) {
+                    long long s = around[i];
+                    if (s == goal) continue;
+                    Node& w = node(s);
+                    w.rhs = min(w.rhs, through);
+                    updateVertex(s);
+                }
+            } else {
+                int oldG = g(u);
+                node(u).g = INF;
+                int through = add(cost(u), oldG);
+                for (int i = 0; i < n; i++) {
+                    long long s = around[i];
+                    if (s != goal && rhs(s) == through) node(s).rhs = bestSuccessor(s);
+                    updateVertex(s);
+                }
+                if (u != goal) node(u).rhs = bestSuccessor(u);
+                updateVertex(u);
+            }
+        }
+        return true;
+    }
+
+public:
+    PathPlanner()
+        : dimX(0), dimY(0), nodes(Node()), blocked(0), start(-1), lastStart(-1), goal(-1), km(0),
+          consistent(false), changed(false) {}
+
+    void setWorldSize(int x, int y) {
+        if (x == dimX && y == dimY) return;
+        dimX = x;
+        dimY = y;
+        blocked.clear();
+        goal = -1;
+    }
+
+    // νεος στοχος: ξεκιναει νεα αναζητηση, τα γνωστα εμποδια μενουν
+    void setGoal(const Position& target) {
+        long long cell = inside(target) ? cellOf(target) : -1;
+        if (cell == goal) return;
+        goal = cell;
+        consistent = false;
+        changed = false;
+        if (goal < 0) return;
+        nodes.clear();
+        open = priority_queue<Entry, vector<Entry>, greater<Entry>>();
+        km = 0;
+        lastStart = -1;
+        start = goal;
+        node(goal).rhs = 0;
+        updateVertex(goal);
+        stats.plans++;
+    }
+
+    // ενα κελι που εγινε γνωστο οτι ειναι κατειλημενο: διορθωνονται μονο οι γειτονες του
+    void block(const Position& p) {
+        if (!inside(p) || blocked.get(p.x, p.y)) return;
+        long long cell = cellOf(p);
+        blocked.set(p.x, p.y, 1);
+        if (goal < 0) return;
+        long long around[4];
+        int n = neighbors(cell, around);
+        for (int i = 0; i < n; i++) {
+            long long s = around[i];
+            if (s == goal) continue;
+            node(s).rhs = bestSuccessor(s);
+            updateVertex(s);
+        }
+        changed = true;
+        consistent = false;
+    }
+
+    // φερνει τη διαδρομη στη θεση του οχηματος με το πολυ budget επεκτασεις κελιων
+    bool plan(const Position& carPos, int budget) {
+        if (goal < 0 || !inside(carPos)) return false;
+        long long cell = cellOf(carPos);
+        if (lastStart >= 0 && cell != lastStart) km += heuristic(lastStart, cell);
+        if (cell != lastStart) consistent = false;
+        lastStart = cell;
+        start = cell;
+        if (consistent) return hasPath();
+        if (changed) {
+            stats.replans++;
+            changed = false;
+        }
+        consistent = computeShortestPath(budget);
+        if (!consistent) stats.budgetHits++;
+        return hasPath();
+    }
+
+    // για το κελι του οχηματος η αναζητηση σταματα μολις το rhs του (η καλυτερη αποσταση μεσω γειτονων) ειναι σωστο
+    bool hasPath() const { return consistent && goal >= 0 && nodes.get(xOf(start), yOf(start)).rhs < INF; }
+
+    // μηκος της διαδρομης απο το οχημα μεχρι τον στοχο
+    int pathLength() const { return hasPath() ? nodes.get(xOf(start), yOf(start)).rhs : -1; }
+
+    // προς τα που ειναι το επομενο κελι της διαδρομης απο το p (στις ισοπαλιες προτιμαει το prefer)
+    Dir nextStep(const Position& p, Dir prefer) const {
+        if (!hasPath() || !inside(p) || cellOf(p) == goal) return Dir::None;
+        static const Dir dirs[] = {Dir::E, Dir::W, Dir::N, Dir::S};
+        static const int stepX[] = {1, -1, 0, 0};
+        static const int stepY[] = {0, 0, 1, -1};
+        Dir best = Dir::None;
+        int bestCost = INF;
+        for (int i = 0; i < 4; i++) {
+            Position next(p.x + stepX[i], p.y + stepY[i]);
+            if (!inside(next)) continue;
+            int c = add(cost(cellOf(next)), nodes.get(next.x, next.y).g);
+            if (c < bestCost || (c == bestCost && dirs[i] == prefer)) {
+                best = dirs[i];
+                bestCost = c;
+            }
+        }
+        return best;
+    }
+
+    // ποσα κελια (το πολυ maxSteps) προχωραει η διαδρομη απο το p ευθεια προς το dir
+    int straightRun(Position p, Dir dir, int maxSteps) const {
+        int steps = 0;
+        while (steps < maxSteps && nextStep(p, dir) == dir) {
+            if (dir == Dir::E) p.x++;
+            else if (dir == Dir::W) p.x--;
+            else if (dir == Dir::N) p.y++;
+            else p.y--;
+            steps++;
+        }
+        return steps;
+    }
+
+    const Stats& getStats() const { return stats; }
+
+    // ολη η κατασταση της αναζητησης (μαζι με την ουρα), ετσι μετα τη φορτωση συνεχιζει ακριβως απο εκει
+    void save(SnapshotWriter& w) const {
+        w.pod(dimX);
+        w.pod(dimY);
+        w.pod(start);
+        w.pod(lastStart);
+        w.pod(goal);
+        w.pod(km);
+        w.pod((int)consistent);
+        w.pod((int)changed);
+        w.pod(stats.expansions);
+        w.pod(stats.plans);
+        w.pod(stats.replans);
+        w.pod(stats.budgetHits);
+
+        // τα tiles περνιουνται με τυχαια σειρα, ταξινομημενα το ιδιο state δινει παντα το ιδιο αρχειο
+        vector<Position> blockedCells;
+        blocked.forEachInRect(0, 0, dimX - 1, dimY - 1, [&](int x, int y, char) { blockedCells.push_back(Position(x, y)); });
+        sort(blockedCells.begin(), blockedCells.end(), [](const Position& a, const Position& b) {
+            return a.y != b.y ? a.y < b.y : a.x < b.x;
+        });
+        w.array(blockedCells);
+
+        vector<NodeRecord> records;
+        nodes.forEachInRect(0, 0, dimX - 1, dimY - 1, [&](int x, int y, const Node& v) {
+            records.push_back({x, y, v.g, v.rhs, v.openK1, v.openK2, (int)v.inOpen});
+        });
+        sort(records.begin(), records.end(), [](const NodeRecord& a, const NodeRecord& b) {
+            return a.y != b.y ? a.y < b.y : a.x < b.x;
+        });
+        w.array(records);
+
+        vector<Entry> entries;
+        priority_queue<Entry, vector<Entry>, greater<Entry>> queue = open;
+        for (; !queue.empty(); queue.pop()) entries.push_back(queue.top());
+        w.array(entries);
+    }
+
+    bool load(SnapshotReader& r) {
+        int flags[2] = {0, 0};
+        if (!r.pod(dimX) || !r.pod(dimY) || !r.pod(start) || !r.pod(lastStart) || !r.pod(goal) || !r.pod(km)
+            || !r.pod(flags[0]) || !r.pod(flags[1]) || !r.pod(stats.expansions) || !r.pod(stats.plans)
+            || !r.pod(stats.replans) || !r.pod(stats.budgetHits)) {
+            return false;
+        }
+        consistent = flags[0] != 0;
+        changed = flags[1] != 0;
+
+        vector<Position> blockedCells;
+        vector<NodeRecord> records;
+        vector<Entry> entries;
+        if (!r.array(blockedCells) || !r.array(records) || !r.array(entries)) return false;
+        blocked.clear();
+        for (const Position& p : blockedCells) blocked.set(p.x, p.y, 1);
+        nodes.clear();
+        for (const NodeRecord& rec : records) {
+            Node& v = nodes.at(rec.x, rec.y);
+            v.g = rec.g;
+            v.rhs = rec.rhs;
+            v.openK1 = rec.openK1;
+            v.openK2 = rec.openK2;
+            v.inOpen = rec.inOpen != 0;
+        }
+        open = priority_queue<Entry, vector<Entry>, greater<Entry>>(greater<Entry>(), move(entries));
+        return r.good();
+    }
+};
+
+class NavigationSystem {
+private:
+    vector<Position> gpsTargets;
+    int currentTargetIndex;
+    SensorFusionEngine fusionEngine;
+    PathPlanner planner;
+    int planBudget;   // επεκτασεις κελιων του planner ανα tick
+    
+public:
+    NavigationSystem(double confidenceThreshold = 0.4) 
+        : currentTargetIndex(0), fusionEngine(confidenceThreshold), planBudget(20000) {
+        LOG(Lifecycle, Info) << "[+NAV: GPS] Hello, I'll be your GPS today\n";
+    }
+    
+    ~NavigationSystem() {
+        LOG(Lifecycle, Info) << "[-NAV: GPS] You've arrived! Shutting down...\n";
+    }
+    
+    void setGPSTargets(const vector<Position>& targets) {
         gpsTargets = targets;
         currentTargetIndex = 0;
-        cout << "Navigation set with " << targets.size() << " targets" << endl;
+        LOG(Decisions, Info) << "Navigation set with " << targets.size() << " targets\n";
     }
     
     Position getCurrentTarget() const {
@@ -594,12 +2687,12 @@ public:
     }
     
     void nextTarget() {
-        if (currentTargetIndex < gpsTargets.size() - 1) {
-            currentTargetIndex++;
-            cout << "Moving to next target: (" << getCurrentTarget().x 
-                 << "," << getCurrentTarget().y << ")" << endl;
+        currentTargetIndex++;
+        if (hasMoreTargets()) {
+            LOG(Decisions, Info) << "Moving to next target: (" << getCurrentTarget().x 
+                 << "," << getCurrentTarget().y << ")\n";
         } else {
-            cout << "Reached final destination!" << endl;
+            LOG(Decisions, Info) << "Reached final destination!\n";
         }
     }
     
@@ -613,8 +2706,12 @@ public:
     bool hasMoreTargets() const {
         return currentTargetIndex < gpsTargets.size();
     }
+
+    void setWorldSize(int dimX, int dimY) { planner.setWorldSize(dimX, dimY); }
+    void setPlanBudget(int budget) { planBudget = budget; }
+    const PathPlanner::Stats& getPlannerStats() const { return planner.getStats(); }
     
-    string makeDecision(const Position& carPos, const string& carDir, 
+    string makeDecision(const Position& carPos, Dir carDir, 
                        const vector<SensorReading>& fusedReadings, int& carSpeed) {
         if (!hasMoreTargets()) return "STOP";
         
@@ -624,6 +2721,13 @@ public:
         if (hasReachedTarget(carPos)) {
             return "NEXT_TARGET";
         }
+
+        // τα παρκαρισμενα που ειδαν οι αισθητηρες γινονται εμποδια και ο planner διορθωνει τη διαδρομη
+        planner.setGoal(target);
+        for (const auto& reading : fusedReadings) {
+            if (reading.objectType == Kind::ParkedCar) planner.block(reading.position);
+        }
+        bool planned = planner.plan(carPos, planBudget);
         
         for (const auto& reading : fusedReadings) {
             if (reading.distance <= 2 && reading.speed > 0) {
@@ -632,17 +2736,32 @@ public:
             }
             
             if (reading.distance <= 3 && 
-                (reading.trafficLight == "RED" || reading.trafficLight == "YELLOW")) {
+                (reading.trafficLight == Light::Red || reading.trafficLight == Light::Yellow)) {
                 // κοκκινο ή κιτρινο φαναρι
                 return "DECELERATE";
             }
             
-            if (reading.distance <= 5 && reading.objectType == "StopSign") {
+            if (reading.distance <= 5 && reading.objectType == Kind::StopSign) {
                 // STOP
                 return "DECELERATE";
             }
         }
         
+        if (planned) {
+            // ακολουθω τη διαδρομη: στριβω οπου στριβει και δεν τρεχω περισσοτερο απο οσο παει ευθεια,
+            // ετσι δεν περναω πανω απο εμποδια ουτε προσπερναω τον στοχο
+            Dir next = planner.nextStep(carPos, carDir);
+            if (next != carDir) {
+                if (planner.straightRun(carPos, next, carSpeed) < carSpeed) return "DECELERATE";
+                return string("TURN_") + dirName(next);
+            }
+            int run = planner.straightRun(carPos, carDir, 3);
+            if (run < carSpeed) return "DECELERATE";
+            if (carSpeed < 2 && run > carSpeed) return "ACCELERATE";
+            return "CONTINUE";
+        }
+
+        // χωρις διαδρομη (στοχος εκτος κοσμου, αποκλεισμενος ή δεν τελειωσε ακομα ο planner) πηγαινω απλα προς τα εκει
         // ελεγχω την απποσταση απο τον στοχο μηπως χρειαζεται να αλλαξω ταχυτητα
         int distanceToTarget = carPos.distanceTo(target);
         if (distanceToTarget <= 5 && carSpeed == 2) {
@@ -660,12 +2779,12 @@ public:
         // ελεγχω για αλλαγη κατευθηνσης 
         if (abs(dx) > abs(dy)) {
             // αναλογα με το προσημο της αποστασης αλαξω κατευθηνση προς τα δεξια(EAST) ή προς τα αριστερα(WEST)  
-            if (dx > 0 && carDir != "E") return "TURN_E";
-            if (dx < 0 && carDir != "W") return "TURN_W";
+            if (dx > 0 && carDir != Dir::E) return "TURN_E";
+            if (dx < 0 && carDir != Dir::W) return "TURN_W";
         } else {
             // αναλογα με το προσημο της αποστασης αλαξω κατευθηνση προς τα πανω(NORTH) ή προς τα κατω(SOUTH)  
-            if (dy > 0 && carDir != "N") return "TURN_N";
-            if (dy < 0 && carDir != "S") return "TURN_S";
+            if (dy > 0 && carDir != Dir::N) return "TURN_N";
+            if (dy < 0 && carDir != Dir::S) return "TURN_S";
         }
         
         // αν ειμαστε στην σωστη κατευθηνση για τον στοχο μας τοτε κανουμε accelerate
@@ -676,8 +2795,27 @@ public:
         return "CONTINUE";
     }
     
-    vector<SensorReading> processSensorData(const vector<SensorReading>& allReadings) {
-        return fusionEngine.fuseSensorData(allReadings);
+    void processSensorData(const vector<SensorReading>& allReadings, int tick, vector<SensorReading>& fused) {
+        fusionEngine.fuseSensorData(allReadings, tick, fused);
+    }
+
+    void predictTracks(const Position& carPos, int tick, vector<SensorReading>& out) {
+        fusionEngine.predictTracks(carPos, tick, out);
+    }
+
+    int trackCount() const { return fusionEngine.trackCount(); }
+
+    void save(SnapshotWriter& w) const {
+        w.array(gpsTargets);
+        w.pod(currentTargetIndex);
+        w.pod(planBudget);
+        fusionEngine.save(w);
+        planner.save(w);
+    }
+
+    bool load(SnapshotReader& r) {
+        return r.array(gpsTargets) && r.pod(currentTargetIndex) && r.pod(planBudget)
+            && fusionEngine.load(r) && planner.load(r);
     }
 };
 
@@ -689,19 +2827,36 @@ private:
     NavigationSystem navigation;
     vector<SensorReading> lastReadings;
     vector<SensorReading> fusedReadings;
+    vector<SensorReading> trackedReadings;    // fusedReadings και οι προβλεψεις για οσα δεν ειδε η σαρωση
+    vector<SensorReading> sensorBuffers[3];   // μια θεση ανα αισθητηρα: camera, lidar, radar
+    string lastDecision;
+    bool outOfBounds;
+    bool verbose;    // μονο το πρωτο οχημα του στολου γραφει τις αποφασεις του
     
 public:
-    SelfDrivingCar(Position pos = Position(0, 0)) 
-        : MovingObject("SelfDrivingCar", 0, "@", pos, 0, "E"),
-          camera(pos.x, pos.y), lidar(pos.x, pos.y), radar(pos.x, pos.y), navigation() {
-        cout << "[+VEHICLE: " << getID() << "] Created at (" << pos.x << "," << pos.y 
-             << "), heading " << direction << " at " << speed << " units/tick" << endl;
+    static const Kind KIND = Kind::SelfDrivingCar;
+
+    SelfDrivingCar(Position pos = Position(0, 0), double confidenceThreshold = 0.4, int num = 0) 
+        : MovingObject(Kind::SelfDrivingCar, num, '@', pos, 0, Dir::E),
+          camera(pos.x, pos.y), lidar(pos.x, pos.y), radar(pos.x, pos.y), navigation(confidenceThreshold),
+          outOfBounds(false), verbose(num == 0) {
+        camera.setOwner(getHandle());
+        lidar.setOwner(getHandle());
+        radar.setOwner(getHandle());
+        // οι buffers των αναγνωσεων κρατανε τη χωρητικοτητα τους, ξεκινανε με οσο χρειαζεται ενας πυκνος δρομος
+        for (auto& buffer : sensorBuffers) buffer.reserve(64);
+        lastReadings.reserve(128);
+        fusedReadings.reserve(128);
+        trackedReadings.reserve(128);
+        LOG(Lifecycle, Info) << "[+VEHICLE: " << getID() << "] Created at (" << pos.x << "," << pos.y 
+             << "), heading " << dirName(direction) << " at " << speed << " units/tick\n";
     }
     
     ~SelfDrivingCar() {
-        cout << "[-CAR: " << getID() << "] Being scrapped..." << endl;
+        LOG(Lifecycle, Info) << "[-CAR: " << getID() << "] Being scrapped...\n";
     }
 
+    // μονο πριν μπει στον κοσμο
     void setPosition(int x, int y) {
         position.x = x;
         position.y = y;
@@ -714,161 +2869,2278 @@ public:
         navigation.setGPSTargets(targets);
     }
 
-    CameraSensor& get_camera() { return camera; }
-    LidarSensor& get_lidar() { return lidar; }
-    RadarSensor& get_radar() { return radar; }
-    NavigationSystem& get_navigation() { return navigation; }
+    CameraSensor& get_camera() { return camera; }
+    LidarSensor& get_lidar() { return lidar; }
+    RadarSensor& get_radar() { return radar; }
+    NavigationSystem& get_navigation() { return navigation; }
+
+    void accelerate() {
+        if (getSpeed() < 2)
+        setSpeed(getSpeed() + 1);
+    }
+    
+    void decelerate() {
+        if (getSpeed() > 0) {
+            setSpeed(getSpeed() - 1);
+        }
+    }
+    
+    void turn(Dir newDir) {
+        if (getDirection() != newDir) {
+            if (verbose) {
+                LOG(Decisions, Debug) << "  Turning from " << dirName(getDirection()) << " to " << dirName(newDir) << "\n";
+            }
+            setDirection(newDir);
+        }
+    }
+    
+    Sensor& sensor(int i) {
+        if (i == 0) return camera;
+        if (i == 1) return lidar;
+        return radar;
+    }
+
+    // οι αισθητηρες μονο διαβαζουν τον κοσμο, αρα με pool σκαναρουν ολοι μαζι, ο καθενας στο δικο του buffer.
+    // η ενωση γινεται παντα με τη σειρα camera, lidar, radar ωστε το αποτελεσμα να ειναι ιδιο με ή χωρις νηματα
+    void collectSensorData(const GridWorld& world, ThreadPool* pool = nullptr) {
+        Position pos = getPosition();
+        Dir dir = getDirection();
+        lastReadings.clear();
+        if (!pool) {
+            // χωρις νηματα γραφουν κατευθειαν στο lastReadings με την ιδια σειρα
+            for (int i = 0; i < 3; i++) sensor(i).scan(world, pos.x, pos.y, dir, lastReadings);
+            return;
+        }
+
+        // η lambda πιανει δυο δεικτες, ετσι χωραει μεσα στο function και δεν δεσμευει μνημη
+        function<void(int)> scanOne = [this, &world](int i) {
+            sensorBuffers[i].clear();
+            sensor(i).scan(world, getPosition().x, getPosition().y, getDirection(), sensorBuffers[i]);
+        };
+        pool->run(3, scanOne);
+        for (int i = 0; i < 3; i++) {
+            lastReadings.insert(lastReadings.end(), sensorBuffers[i].begin(), sensorBuffers[i].end());
+        }
+    }
+    
+    // αν εγινε σαρωση σε αυτο το tick ενημερωνει τα tracks, και σε καθε tick ετοιμαζει για την αποφαση
+    // οσα ειδε η σαρωση μαζι με τις προβλεψεις για τα υπολοιπα
+    void syncNavigationSystem(int tick, bool scanned = true) {
+        if (scanned) navigation.processSensorData(lastReadings, tick, fusedReadings);
+        else fusedReadings.clear();
+        trackedReadings = fusedReadings;
+        navigation.predictTracks(getPosition(), tick, trackedReadings);
+    }
+    
+    // παιρνει την αποφαση χωρις να αλλαξει τον κοσμο, ετσι ολος ο στολος αποφασιζει παραλληλα
+    void decide(const GridWorld& world) {
+        navigation.setWorldSize(world.getDimX(), world.getDimY());
+        int speed = getSpeed();
+        lastDecision = navigation.makeDecision(getPosition(), getDirection(), trackedReadings, speed);
+    }
+
+    // εφαρμοζει την τελευταια αποφαση και κινει το οχημα, επιστρεφει false αν σταματησε για τα καλα
+    bool applyDecision(GridWorld& world) {
+        const string& decision = lastDecision;
+        if (verbose) {
+            LOG(Decisions, Debug) << "  Decision: " << decision << "\n";
+        }
+        
+        if (decision == "ACCELERATE") {
+            accelerate();
+        } else if (decision == "DECELERATE") {
+            decelerate();
+        } else if (decision == "TURN_E") {
+            turn(Dir::E);
+        } else if (decision == "TURN_W") {
+            turn(Dir::W);
+        } else if (decision == "TURN_N") {
+            turn(Dir::N);
+        } else if (decision == "TURN_S") {
+            turn(Dir::S);
+        } else if (decision == "NEXT_TARGET") {
+            navigation.nextTarget();
+            return true;
+        } else if (decision == "STOP") {
+            setSpeed(0);
+            if (verbose) {
+                LOG(Decisions, Info) << "  Final destination reached!\n";
+            }
+            return false;
+        }
+        
+        // Move the car
+        if (getSpeed() > 0) {
+            if (!move(world)) {
+                if (verbose) {
+                    LOG(Decisions, Warn) << "!!! CAR WENT OUT OF BOUNDS !!!\n";
+                }
+                outOfBounds = true;
+                // μενει στο οριο σταματημενο, τα αλλα οχηματα το βλεπουν σαν εμποδιο
+                setSpeed(0);
+                return false;
+            }
+        }
+        
+        return true;
+    }
+
+    // σηναρτηση για την εκτελεση των αποφασεων 
+    bool executeMovement(GridWorld& world) {
+        decide(world);
+        return applyDecision(world);
+    }
+    
+    const vector<SensorReading>& getLastReadings() const {
+        return lastReadings;
+    }
+    
+    const vector<SensorReading>& getFusedReadings() const {
+        return fusedReadings;
+    }
+
+    const vector<SensorReading>& getTrackedReadings() const {
+        return trackedReadings;
+    }
+
+    const string& getLastDecision() const { return lastDecision; }
+    bool wentOutOfBounds() const { return outOfBounds; }
+
+    // οτι χρειαζεται για να συνεχισει απο το επομενο tick: οι αναγνωσεις ξαναγεμιζουν σε καθε tick,
+    // η θεση, η ταχυτητα και η κατευθυνση ειναι στο store του κοσμου
+    void save(SnapshotWriter& w) const {
+        w.pod((int)outOfBounds);
+        w.str(lastDecision);
+        navigation.save(w);
+    }
+
+    bool load(SnapshotReader& r) {
+        int flag = 0;
+        if (!r.pod(flag) || !r.str(lastDecision)) return false;
+        outOfBounds = flag != 0;
+        return navigation.load(r);
+    }
+    
+    Kind getKind() const override { return KIND; }
+    string getType() const override { return "SelfDrivingCar"; }
+};
+
+//renderer που χτιζει ολο το frame σε ενα buffer που ξαναχρησιμοποιειται, με ενα περασμα πανω στις οντοτητες,
+//και το γραφει με ενα write. στο live mode ξαναγραφει μονο τα κελια που αλλαξαν με κινησεις κερσορα (ANSI)
+class FrameRenderer {
+private:
+    int width, height;          // διαστασεις του frame μαζι με το περιγραμμα
+    vector<char> frame;         // το τρεχον frame, γραμμη προς γραμμη χωρις αλλαγες γραμμης
+    vector<char> previous;      // οτι εχει ηδη εμφανιστει στο τερματικο (live mode)
+    string output;              // τα bytes που θα γραφτουν, κρατανε τη χωρητικοτητα τους
+    bool liveStarted;
+
+    static char glyphOf(const EntityStore& store, int s) {
+        static const char glyphs[] = {'B', 'C', 'P', 'S', '?', '@'};
+        if (store.kind[s] == Kind::TrafficLight) return lightGlyph(store.light(s));
+        return glyphs[(int)store.kind[s]];
+    }
+
+    // γεμιζει το frame με τον κοσμο: "X" στα ορια, "." στα αδεια κελια, ο πρωτος της λιστας καθε κελιου
+    // δινει το συμβολο (οπως η getObjectAt), τα αυτονομα οχηματα ειναι στον κοσμο με "@"
+    void build(const GridWorld& world) {
+        int dimX = world.getDimX();
+        int dimY = world.getDimY();
+        width = dimX + 2;
+        height = dimY + 2;
+        frame.assign((size_t)width * height, '.');
+        for (int x = 0; x < width; x++) {
+            frame[x] = 'X';
+            frame[(size_t)(height - 1) * width + x] = 'X';
+        }
+        for (int row = 0; row < height; row++) {
+            frame[(size_t)row * width] = 'X';
+            frame[(size_t)row * width + width - 1] = 'X';
+        }
+
+        const EntityStore& store = world.getStore();
+        int n = store.size();
+        for (int s = 0; s < n; s++) {
+            if (store.cellPrev[s] != -1) continue;
+            frame[(size_t)(dimY - store.y[s]) * width + store.x[s] + 1] = glyphOf(store, s);
+        }
+    }
+
+    void flush(ostream& out) {
+        out.write(output.data(), output.size());
+    }
+
+    // γραφει τον αριθμο στο output χωρις προσωρινο string
+    void appendNumber(int v) {
+        char digits[12];
+        int n = 0;
+        unsigned u = v < 0 ? 0u - (unsigned)v : (unsigned)v;
+        do {
+            digits[n++] = (char)('0' + u % 10);
+            u /= 10;
+        } while (u);
+        if (v < 0) output += '-';
+        while (n > 0) output += digits[--n];
+    }
+
+public:
+    FrameRenderer() : width(0), height(0), liveStarted(false) {}
+
+    // πληρης εικονα του κοσμου
+    void renderFull(const GridWorld& world, ostream& out) {
+        build(world);
+        output.clear();
+        for (int row = 0; row < height; row++) {
+            output.append(&frame[(size_t)row * width], width);
+            output += '\n';
+        }
+        flush(out);
+    }
+
+    // το παραθυρο (2*radius+1)^2 γυρω απο το οχημα, κενο εκτος οριων
+    void renderPov(const GridWorld& world, const Position& carPos, Dir carDir, int radius, ostream& out) {
+        int side = 2 * radius + 1;
+        frame.assign((size_t)side * side, ' ');
+        for (int y = carPos.y + radius; y >= carPos.y - radius; y--) {
+            for (int x = carPos.x - radius; x <= carPos.x + radius; x++) {
+                if (world.inBounds(x, y)) frame[(size_t)(carPos.y + radius - y) * side + x - carPos.x + radius] = '.';
+            }
+        }
+
+        const EntityStore& store = world.getStore();
+        world.forEachSlotInRect(carPos.x - radius, carPos.y - radius, carPos.x + radius, carPos.y + radius, [&](int s) {
+            if (store.cellPrev[s] != -1) return;
+            frame[(size_t)(carPos.y + radius - store.y[s]) * side + store.x[s] - carPos.x + radius] = glyphOf(store, s);
+        });
+
+        output.clear();
+        output += "\n=== CAR'S POINT OF VIEW (radius: ";
+        appendNumber(radius);
+        output += ") ===\nCar at (";
+        appendNumber(carPos.x);
+        output += ',';
+        appendNumber(carPos.y);
+        output += ") facing ";
+        output += dirName(carDir);
+        output += '\n';
+        for (int row = 0; row < side; row++) {
+            output.append(&frame[(size_t)row * side], side);
+            output += '\n';
+        }
+        flush(out);
+    }
+
+    // live mode: το πρωτο frame καθαριζει την οθονη και γραφεται ολοκληρο, μετα γραφονται μονο
+    // τα κελια που αλλαξαν (συνεχομενα κελια της ιδιας γραμμης με μια κινηση κερσορα)
+    void renderLive(const GridWorld& world, int tick, ostream& out) {
+        build(world);
+        output.clear();
+        if (!liveStarted || previous.size() != frame.size()) {
+            output += "\x1b[2J\x1b[H";
+            for (int row = 0; row < height; row++) {
+                output.append(&frame[(size_t)row * width], width);
+                output += '\n';
+            }
+            liveStarted = true;
+        } else {
+            for (int row = 0; row < height; row++) {
+                const char* now = &frame[(size_t)row * width];
+                const char* before = &previous[(size_t)row * width];
+                int col = 0;
+                while (col < width) {
+                    if (now[col] == before[col]) {
+                        col++;
+                        continue;
+                    }
+                    int end = col;
+                    while (end < width && now[end] != before[end]) end++;
+                    output += "\x1b[";
+                    appendNumber(row + 1);
+                    output += ';';
+                    appendNumber(col + 1);
+                    output += 'H';
+                    output.append(now + col, end - col);
+                    col = end;
+                }
+            }
+        }
+        output += "\x1b[";
+        appendNumber(height + 1);
+        output += ";1H\x1b[Ktick ";
+        appendNumber(tick);
+        output += '\n';
+        previous = frame;
+        flush(out);
+        out.flush();
+    }
+};
+
+//συναρτηση για την εκτηποση του κοσμου
+void visualization_full(const GridWorld& world, FrameRenderer& renderer) {
+    if (!Logger::enabled(LogCat::Render, LogLevel::Info)) return;
+    renderer.renderFull(world, Logger::out());
+}
+
+// υλοποιω μια συναρτηση για την μερικη οπτικοποιηση  και γινεται σε καθε κυκλο (tick)
+void visualization_pov(const GridWorld& world, const SelfDrivingCar& car, FrameRenderer& renderer, int radius = 5) {
+    if (!Logger::enabled(LogCat::Render, LogLevel::Info)) return;
+    renderer.renderPov(world, car.getPosition(), car.getDirection(), radius, Logger::out());
+}
+
+// τυχαια θεση για το i-οστο αντικειμενο ενος ειδους απο τη ροη τοποθετησης, ξαναδοκιμαζει οσο πεφτει πανω στο οχημα
+Position random_position(Kind kind, int i, int dimX, int dimY, const Position& avoid) {
+    uint32_t key = Rng::key(Rng::Placement, (uint32_t)kind);
+    uint64_t counter = (uint64_t)i << 32;
+    Position pos;
+    do {
+        pos.x = Rng::below(key, counter++, dimX);
+        pos.y = Rng::below(key, counter++, dimY);
+    } while (pos == avoid);
+    return pos;
+}
+
+// το ιδιο, ξαναδοκιμαζει οσο πεφτει σε καποιο απο τα κελια avoid
+Position random_position(Kind kind, int i, int dimX, int dimY, const vector<Position>& avoid) {
+    uint32_t key = Rng::key(Rng::Placement, (uint32_t)kind);
+    uint64_t counter = (uint64_t)i << 32;
+    Position pos;
+    do {
+        pos.x = Rng::below(key, counter++, dimX);
+        pos.y = Rng::below(key, counter++, dimY);
+    } while (find(avoid.begin(), avoid.end(), pos) != avoid.end());
+    return pos;
+}
+
+//μετρητης δεσμευσεων μνημης για τα benchmarks, μονο με -DALLOC_COUNTING ωστε οι κανονικες εκτελεσεις να μην
+//πληρωνουν ενα atomic σε καθε new. τοτε ολα τα new του προγραμματος (και τα nothrow και με alignment) περνανε
+//απο τα δυο βασικα και ολα τα delete απο το ενα. αυτα μενουν εκτος inline, αλλιως ο compiler βλεπει free πανω
+//σε δεικτη του new και προειδοποιει για ασυμφωνη αποδεσμευση. χωρις τη σημαια ο μετρητης μενει 0
+static atomic<long long> allocationCount(0);
+
+#ifdef ALLOC_COUNTING
+const bool allocationsCounted = true;
+
+__attribute__((noinline)) void* operator new(size_t size) {
+    allocationCount.fetch_add(1, memory_order_relaxed);
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw bad_alloc();
+}
+
+__attribute__((noinline)) void* operator new(size_t size, align_val_t align) {
+    allocationCount.fetch_add(1, memory_order_relaxed);
+    size_t a = (size_t)align;
+    if (void* p = aligned_alloc(a, (max(size, (size_t)1) + a - 1) / a * a)) return p;
+    throw bad_alloc();
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+void* operator new[](size_t size, align_val_t align) { return operator new(size, align); }
+
+void* operator new(size_t size, const nothrow_t&) noexcept {
+    try { return operator new(size); } catch (...) { return nullptr; }
+}
+void* operator new[](size_t size, const nothrow_t&) noexcept {
+    try { return operator new(size); } catch (...) { return nullptr; }
+}
+void* operator new(size_t size, align_val_t align, const nothrow_t&) noexcept {
+    try { return operator new(size, align); } catch (...) { return nullptr; }
+}
+void* operator new[](size_t size, align_val_t align, const nothrow_t&) noexcept {
+    try { return operator new(size, align); } catch (...) { return nullptr; }
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { operator delete(p); }
+void operator delete[](void* p) noexcept { operator delete(p); }
+void operator delete[](void* p, size_t) noexcept { operator delete(p); }
+void operator delete(void* p, const nothrow_t&) noexcept { operator delete(p); }
+void operator delete[](void* p, const nothrow_t&) noexcept { operator delete(p); }
+void operator delete(void* p, align_val_t) noexcept { operator delete(p); }
+void operator delete[](void* p, align_val_t) noexcept { operator delete(p); }
+void operator delete(void* p, size_t, align_val_t) noexcept { operator delete(p); }
+void operator delete[](void* p, size_t, align_val_t) noexcept { operator delete(p); }
+void operator delete(void* p, align_val_t, const nothrow_t&) noexcept { operator delete(p); }
+void operator delete[](void* p, align_val_t, const nothrow_t&) noexcept { operator delete(p); }
+#else
+const bool allocationsCounted = false;
+#endif
+
+//βοηθητικη για τις μετρησεις: το ειδος ενος αντικειμενου με βαση τον αυξοντα αριθμο του
+//(40% ποδηλατα, 30% αυτοκινητα, 20% παρκαρισμενα, 5% STOP, 5% φαναρια)
+Kind bench_kind(int i) {
+    int k = i % 20;
+    if (k < 8) return Kind::Bike;
+    if (k < 14) return Kind::Car;
+    if (k < 18) return Kind::ParkedCar;
+    if (k < 19) return Kind::StopSign;
+    return Kind::TrafficLight;
+}
+
+//μετραω το ιδιο tick (update, κινηση, περασμα ολων των οντοτητων οπως εκαναν οι αισθητηρες)
+//με την παλια διαταξη (Object* με virtual κλησεις και vector αντικειμενων ανα κελι) και με το EntityStore
+void bench_layout(int entities, int benchTicks = 10) {
+    int side = max(10, (int)sqrt(entities * 4.0)); // ~25% πληροτητα
+    double legacyMs[3] = {0, 0, 0};
+    double storeMs[3] = {0, 0, 0};
+    long long checksum = 0;
+    auto ms = [](chrono::steady_clock::time_point a, chrono::steady_clock::time_point b) {
+        return chrono::duration<double, milli>(b - a).count();
+    };
+
+    // σιωπω τα μηνυματα δημιουργιας/καταστροφης για να μετραω μονο την προσομοιωση
+    unsigned savedCategories = Logger::categories;
+    Logger::categories = 0;
+    {
+        Rng::seed = 1;
+        uint32_t placement = Rng::key(Rng::Placement, 0);
+        GridWorld bounds(side, side); // μονο για τα ορια, τα παλια αντικειμενα μενουν εκτος κοσμου
+        GridWorld world(side, side);
+        vector<Object*> legacy;
+        legacy.reserve(entities);
+        unordered_map<long long, vector<Object*>> legacyCells;
+        auto legacyKey = [](const Position& pos) { return ((long long)pos.x << 32) | (unsigned int)pos.y; };
+        for (int i = 0; i < entities; i++) {
+            Position pos(Rng::below(placement, 2 * (uint64_t)i, side), Rng::below(placement, 2 * (uint64_t)i + 1, side));
+            Object* old = make_object(bench_kind(i), pos);
+            Object* obj = world.create(bench_kind(i), pos);
+            if (MovingObject* mover = dynamic_cast<MovingObject*>(obj)) {
+                mover->setDirection(old->getDirection());
+            }
+            legacy.push_back(old);
+            legacyCells[legacyKey(pos)].push_back(old);
+            world.addObject(obj);
+        }
+        const EntityStore& store = world.getStore();
+
+        for (int tick = 0; tick < benchTicks; tick++) {
+            auto t0 = chrono::steady_clock::now();
+            for (auto obj : legacy) obj->update(tick);
+            auto t1 = chrono::steady_clock::now();
+            for (auto obj : legacy) {
+                Position before = obj->getPosition();
+                if (Bike* bike = dynamic_cast<Bike*>(obj)) bike->move(bounds);
+                else if (OtherCar* otherCar = dynamic_cast<OtherCar*>(obj)) otherCar->move(bounds);
+                Position after = obj->getPosition();
+                if (after != before) {
+                    auto cell = legacyCells.find(legacyKey(before));
+                    cell->second.erase(find(cell->second.begin(), cell->second.end(), obj));
+                    if (cell->second.empty()) legacyCells.erase(cell);
+                    legacyCells[legacyKey(after)].push_back(obj);
+                }
+            }
+            auto t2 = chrono::steady_clock::now();
+            for (auto obj : legacy) {
+                Position pos = obj->getPosition();
+                checksum += pos.x + pos.y + obj->getSpeed() + (int)obj->getDirection() + (int)obj->getTrafficLight();
+            }
+            auto t3 = chrono::steady_clock::now();
+            legacyMs[0] += ms(t0, t1);
+            legacyMs[1] += ms(t1, t2);
+            legacyMs[2] += ms(t2, t3);
+
+            t0 = chrono::steady_clock::now();
+            world.updateAll(tick);
+            t1 = chrono::steady_clock::now();
+            for (int s = 0; s < store.size(); s++) {
+                if (store.kind[s] == Kind::Bike || store.kind[s] == Kind::Car) world.moveEntity(s);
+            }
+            t2 = chrono::steady_clock::now();
+            for (int s = 0; s < store.size(); s++) {
+                checksum += store.x[s] + store.y[s] + store.speed[s] + (int)store.dir[s] + (int)store.light(s);
+            }
+            t3 = chrono::steady_clock::now();
+            storeMs[0] += ms(t0, t1);
+            storeMs[1] += ms(t1, t2);
+            storeMs[2] += ms(t2, t3);
+        }
+
+        for (auto obj : legacy) delete obj;
+    }
+    Logger::categories = savedCategories;
+
+    const char* phases[] = {"update", "move", "sweep"};
+    double legacyTotal = 0, storeTotal = 0;
+    cout << "Layout benchmark: " << entities << " entities, world " << side << "x" << side
+         << ", " << benchTicks << " ticks (checksum " << checksum << ")" << endl;
+    cout << fixed << setprecision(2);
+    cout << "  phase      Object* ms/tick   EntityStore ms/tick" << endl;
+    for (int p = 0; p < 3; p++) {
+        cout << "  " << left << setw(10) << phases[p] << right << setw(16) << legacyMs[p] / benchTicks
+             << setw(22) << storeMs[p] / benchTicks << endl;
+        legacyTotal += legacyMs[p];
+        storeTotal += storeMs[p];
+    }
+    cout << "  " << left << setw(10) << "total" << right << setw(16) << legacyTotal / benchTicks
+         << setw(22) << storeTotal / benchTicks << endl;
+    cout << "  entity-ticks/s: Object* " << setprecision(0) << entities * (double)benchTicks / (legacyTotal / 1000.0)
+         << ", EntityStore " << entities * (double)benchTicks / (storeTotal / 1000.0) << endl;
+    cout.unsetf(ios::fixed);
+    cout << setprecision(6);
+}
+
+//μετραω τη σαρωση του lidar σε διαφορες πυκνοτητες: τον παλιο βροχο (double, ενα αντικειμενο τη φορα, χωρις
+//οπτικη επαφη) απεναντι στο LidarSensor::scan με καθε υλοποιηση του ScanKernel, τον πυρηνα μονο του πανω σε ολο
+//το EntityStore και τις ακτινες της LineOfSight σε αποστασεις lidar, radar και πιο μακρια
+void bench_scan(int scans) {
+    const int side = 256;
+    const double densities[] = {0.02, 0.1, 0.5, 2.0};
+    const int range = 4;
+    auto ns = [](chrono::steady_clock::time_point a, chrono::steady_clock::time_point b) {
+        return chrono::duration<double, nano>(b - a).count();
+    };
+    vector<ScanKernel::Isa> isas;
+    for (ScanKernel::Isa isa : {ScanKernel::Isa::Scalar, ScanKernel::Isa::SSE2, ScanKernel::Isa::AVX2}) {
+        if (ScanKernel::supported(isa)) isas.push_back(isa);
+    }
+    ScanKernel::Isa savedIsa = ScanKernel::active;
+
+    unsigned savedCategories = Logger::categories;
+    Logger::categories = 0;
+    cout << "Scan benchmark: world " << side << "x" << side << ", " << scans << " lidar scans per density, kernel "
+         << ScanKernel::isaName(ScanKernel::detect()) << " available" << endl;
+    cout << fixed << setprecision(1);
+    for (double density : densities) {
+        Rng::seed = 1;
+        uint32_t placement = Rng::key(Rng::Placement, 0);
+        int entities = (int)(side * side * density);
+        GridWorld world(side, side);
+        for (int i = 0; i < entities; i++) {
+            Position pos(Rng::below(placement, 2 * (uint64_t)i, side), Rng::below(placement, 2 * (uint64_t)i + 1, side));
+            world.spawn(bench_kind(i), pos);
+        }
+        const EntityStore& store = world.getStore();
+        vector<Position> cars(scans);
+        uint32_t carKey = Rng::key(Rng::Placement, 1000);
+        for (int i = 0; i < scans; i++) {
+            cars[i] = Position(Rng::below(carKey, 2 * (uint64_t)i, side), Rng::below(carKey, 2 * (uint64_t)i + 1, side));
+        }
+        long long checksum = 0;
+
+        // ο βροχος οπως ηταν πριν τον ScanKernel
+        uint32_t legacyKey = Rng::key(Rng::SensorNoise, 0);
+        vector<int> candidates;
+        vector<SensorReading> results;
+        auto t0 = chrono::steady_clock::now();
+        for (const Position& car : cars) {
+            results.clear();
+            candidates.clear();
+            world.queryRectSlots(car.x - range, car.y - range, car.x + range, car.y + range, candidates);
+            for (int s : candidates) {
+                int dx = store.x[s] - car.x;
+                int dy = store.y[s] - car.y;
+                if (abs(dx) <= range && abs(dy) <= range) {
+                    SensorReading reading;
+                    reading.objectType = store.kind[s];
+                    reading.objectId = store.handle[s];
+                    reading.position = Position(store.x[s], store.y[s]);
+                    reading.distance = abs(dx) + abs(dy);
+                    double confidence = 0.99 * (1.0 - (reading.distance / (double)(range * 2)));
+                    confidence += (Rng::below(legacyKey, store.handle[s], 11) - 5) * 0.01;
+                    reading.confidence = (float)max(0.0, min(1.0, confidence));
+                    reading.speed = store.speed[s];
+                    reading.direction = store.dir[s];
+                    reading.trafficLight = store.light(s);
+                    results.push_back(reading);
+                }
+            }
+            checksum += results.size();
+        }
+        double legacyNs = ns(t0, chrono::steady_clock::now()) / scans;
+
+        cout << "  density " << setprecision(2) << density << " (" << entities << " entities, " << setprecision(1)
+             << checksum / (double)scans << " hits/scan)" << endl;
+        cout << "    lidar scan  legacy   " << setw(10) << legacyNs << " ns/scan" << endl;
+
+        LidarSensor lidar(0, 0);
+        long long visible = -1;
+        for (ScanKernel::Isa isa : isas) {
+            ScanKernel::active = isa;
+            long long hits = 0;
+            t0 = chrono::steady_clock::now();
+            for (const Position& car : cars) {
+                results.clear();
+                lidar.scan(world, car.x, car.y, Dir::E, results);
+                hits += results.size();
+            }
+            double scanNs = ns(t0, chrono::steady_clock::now()) / scans;
+            if (visible < 0) visible = hits;
+            cout << "    lidar scan  " << left << setw(8) << ScanKernel::isaName(isa) << right << setw(10) << scanNs
+                 << " ns/scan, " << hits / (double)scans << " hits/scan in sight" << (hits == visible ? "" : "  (hit count differs!)") << endl;
+        }
+
+        // ακτινες απο καθε οχημα προς τυχαια κελια του κουτιου του, με ενα load ανα οχημα οπως στη σαρωση
+        LineOfSight sight;
+        uint32_t rayKey = Rng::key(Rng::Placement, 2000);
+        const int raysPerCar = 32;
+        for (int rayRange : {4, 12, 32}) {
+            long long rays = 0, clear = 0;
+            t0 = chrono::steady_clock::now();
+            for (int i = 0; i < scans; i++) {
+                const Position& car = cars[i];
+                sight.load(world, car.x - rayRange, car.y - rayRange, car.x + rayRange, car.y + rayRange);
+                for (int k = 0; k < raysPerCar; k++) {
+                    uint64_t ray = (uint64_t)i * raysPerCar + k;
+                    int tx = min(side - 1, max(0, car.x + (int)Rng::below(rayKey, 2 * ray, 2 * rayRange + 1) - rayRange));
+                    int ty = min(side - 1, max(0, car.y + (int)Rng::below(rayKey, 2 * ray + 1, 2 * rayRange + 1) - rayRange));
+                    clear += sight.clear(car.x, car.y, tx, ty);
+                    rays++;
+                }
+            }
+            double rayNs = ns(t0, chrono::steady_clock::now());
+            cout << "    rays r=" << left << setw(4) << rayRange << right << setw(16) << rays / (rayNs / 1000.0)
+                 << " M rays/s, " << 100.0 * clear / rays << "% clear" << endl;
+        }
+
+        // ο πυρηνας μονος του πανω σε ολες τις θεσεις, χωρις το χωρικο ευρετηριο
+        ScanParams p;
+        p.carX = p.carY = side / 2;
+        p.dxMin = p.dyMin = -range;
+        p.dxMax = p.dyMax = range;
+        p.wx = p.wy = 1;
+        p.base = 0.99f;
+        p.scale = (float)(range * 2);
+        p.noiseKey = legacyKey;
+        p.tick = 0;
+        int n = store.size();
+        vector<uint8_t> mask((n + 7) / 8), referenceMask;
+        vector<float> conf(n), referenceConf;
+        vector<int> dist(n), referenceDist;
+        int sweeps = max(1, 20000000 / max(1, n));
+        for (ScanKernel::Isa isa : isas) {
+            t0 = chrono::steady_clock::now();
+            for (int r = 0; r < sweeps; r++) {
+                ScanKernel::run(isa, p, store.x.data(), store.y.data(), store.handle.data(), n, mask.data(), conf.data(), dist.data());
+            }
+            double sweepNs = ns(t0, chrono::steady_clock::now()) / sweeps;
+            bool same = true;
+            if (referenceMask.empty()) {
+                referenceMask = mask;
+                referenceConf = conf;
+                referenceDist = dist;
+            } else {
+                same = mask == referenceMask && dist == referenceDist && memcmp(conf.data(), referenceConf.data(), n * sizeof(float)) == 0;
+            }
+            cout << "    kernel      " << left << setw(8) << ScanKernel::isaName(isa) << right << setw(10)
+                 << n / (sweepNs / 1000.0) << " M entities/s" << (same ? "" : "  (differs from scalar!)") << endl;
+        }
+    }
+    cout.unsetf(ios::fixed);
+    cout << setprecision(6);
+    ScanKernel::active = savedIsa;
+    Logger::categories = savedCategories;
+}
+
+//οι παραμετροι ενος σεναριου, οπως τις δινει ο χρηστης
+//περιοχη του κοσμου (--region) με δικο της ποσοστο κατειλημενων κελιων
+struct DensityRegion {
+    int x0, y0, x1, y1;   // μαζι με τα ακρα
+    double density;       // 0..1
+
+    long long cells() const { return (long long)(x1 - x0 + 1) * (y1 - y0 + 1); }
+    long long target() const { return llround(density * cells()); }
+    bool contains(int x, int y) const { return x >= x0 && x <= x1 && y >= y0 && y <= y1; }
+};
+
+struct Scenario {
+    int dimX, dimY;
+    int movingCars, movingBikes, parkedCars, stopSigns, trafficLights;
+    int ticks;
+    double minConfidenceThreshold;
+    int sensorRate;
+    int planBudget;
+    int fleet;                       // ποσα αυτονομα οχηματα, το πρωτο ακολουθει τα destinations
+    vector<Position> destinations;   // η αρχικη θεση του οχηματος και μετα οι στοχοι
+    vector<DensityRegion> regions;   // μονο για τη δημιουργια του κοσμου, δεν μπαινουν στο snapshot
+
+    long long entities() const {
+        return (long long)movingCars + movingBikes + parkedCars + stopSigns + trafficLights;
+    }
+};
+
+// ελεγχει οτι οι περιοχες και οι οντοτητες του σεναριου χωρανε στον κοσμο, αλλιως τυπωνει το λαθος
+bool check_scenario(const Scenario& sc) {
+    long long cells = (long long)sc.dimX * sc.dimY;
+    long long regionCells = 0, regionTargets = 0;
+    for (size_t i = 0; i < sc.regions.size(); i++) {
+        const DensityRegion& r = sc.regions[i];
+        if (r.x0 < 0 || r.y0 < 0 || r.x1 >= sc.dimX || r.y1 >= sc.dimY || r.x0 > r.x1 || r.y0 > r.y1) {
+            cout << "ERROR: Region (" << r.x0 << "," << r.y0 << ")-(" << r.x1 << "," << r.y1 << ") is not inside the world" << endl;
+            return false;
+        }
+        if (!(r.density >= 0 && r.density <= 1)) {
+            cout << "ERROR: Region density must be between 0 and 1" << endl;
+            return false;
+        }
+        for (size_t j = 0; j < i; j++) {
+            const DensityRegion& o = sc.regions[j];
+            if (r.x0 <= o.x1 && o.x0 <= r.x1 && r.y0 <= o.y1 && o.y0 <= r.y1) {
+                cout << "ERROR: Regions (" << o.x0 << "," << o.y0 << ")-(" << o.x1 << "," << o.y1 << ") and ("
+                     << r.x0 << "," << r.y0 << ")-(" << r.x1 << "," << r.y1 << ") overlap" << endl;
+                return false;
+            }
+        }
+        regionCells += r.cells();
+        regionTargets += r.target();
+    }
+    if (sc.entities() + sc.fleet > cells) {
+        cout << "ERROR: " << sc.entities() << " entities and " << sc.fleet << " vehicles do not fit in a "
+             << sc.dimX << "x" << sc.dimY << " world" << endl;
+        return false;
+    }
+    if (regionTargets > sc.entities()) {
+        cout << "ERROR: The regions need " << regionTargets << " entities but the scenario has " << sc.entities() << endl;
+        return false;
+    }
+    // τα οχηματα μπορει να ξεκινανε ολα εξω απο τις περιοχες
+    if (sc.entities() - regionTargets + sc.fleet > cells - regionCells) {
+        cout << "ERROR: " << sc.entities() - regionTargets << " entities do not fit outside the regions" << endl;
+        return false;
+    }
+    return true;
+}
+
+//τι εγινε σε μια προσομοιωση
+struct SimResult {
+    bool reachedAll = false;      // εφτασε σε ολους τους στοχους
+    bool outOfBounds = false;     // το οχημα προσπαθησε να βγει απο τον κοσμο
+    int ticks = 0;                // ticks που ετρεξαν
+    int ticksToTarget = -1;       // το tick που εφτασε στον τελευταιο στοχο
+    Position finalPosition;
+    map<string, int> decisions;   // ποσες φορες πηρε καθε αποφαση
+    PathPlanner::Stats planner;
+    int cars = 1;                 // οχηματα του στολου
+    int carsReached = 0;          // οσα εφτασαν σε ολους τους στοχους τους
+    long long collisions = 0;     // συγκρουσεις κινουμενων (δες CollisionDetector)
+    long long crossings = 0;      // απο αυτες, οσες εγιναν στη διαδρομη και οχι στο ιδιο κελι στο τελος
+    long long carCollisions = 0;  // οσες εμπλεκουν αυτονομο οχημα
+    int collisionTicks = 0;       // ticks με τουλαχιστον μια συγκρουση
+    int maxCollisionsPerTick = 0;
+    bool damagedSnapshot = false; // το --loadSnapshot απορριφθηκε, δεν ετρεξε τιποτα
+};
+
+// ξεκιναει νεα προσομοιωση στο τρεχον νημα: η αριθμηση των αντικειμενων και των αισθητηρων και το seed
+// ειναι ανα νημα, ετσι το ιδιο seed δινει τον ιδιο κοσμο οτι κι αν ετρεξε πριν ή σε αλλο νημα
+void begin_simulation(uint64_t seed) {
+    Rng::seed = seed;
+    Object::resetCounters();
+    Sensor::resetCounter();
+}
+
+//αρχη του αρχειου snapshot, ακολουθουν οι στηλες του EntityStore, τα slot των αυτονομων οχηματων με το
+//ποια τρεχουν ακομα και η κατασταση καθε οχηματος. το μονο που δεν αποθηκευεται ειναι οι δεικτες owner
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    int32_t tick;             // το επομενο tick που θα τρεξει
+    uint64_t seed;
+    int32_t dimX, dimY;
+    int32_t movingCars, movingBikes, parkedCars, stopSigns, trafficLights;
+    int32_t ticks, sensorRate, planBudget, fleet;
+    int32_t ticksToTarget, outOfBounds;
+    int32_t collisionTicks, maxCollisionsPerTick;
+    int64_t collisions, crossings, carCollisions;
+    int32_t objectCounters[6];
+    int32_t sensorCounter;
+    double minConfidenceThreshold;
+};
+
+//snapshot ολης της προσομοιωσης σε ενα tick, για συνεχεια απο εκει ή για πολλα πειραματα απο την ιδια αφετηρια.
+//η φορτωση κανει mmap το αρχειο και αντιγραφει καθε στηλη του store με μια κινηση. τα αντικειμενα ομως
+//ξαναφτιαχνονται ενα ενα με τους constructors τους και μετα δενονται στα slot τους
+class Snapshot {
+private:
+    static constexpr uint32_t VERSION = 3;
+    MappedFile file;
+    SnapshotHeader header;
+
+    static void stamp(char magic[8]) { memcpy(magic, "SDCSNAP", 8); }
+
+public:
+    bool open(const string& path) {
+        if (!file.open(path) || file.size() < sizeof(SnapshotHeader)) return false;
+        memcpy(&header, file.data(), sizeof(header));
+        char magic[8];
+        stamp(magic);
+        if (memcmp(header.magic, magic, 8) != 0 || header.version != VERSION) return false;
+        // τα ιδια ορια με τις παραμετρους της γραμμης εντολων, το υπολοιπο σεναριο το ελεγχει η check_scenario
+        const SnapshotHeader& h = header;
+        return h.tick >= 0 && h.dimX > 0 && h.dimY > 0 && h.movingCars >= 0 && h.movingBikes >= 0 && h.parkedCars >= 0
+               && h.stopSigns >= 0 && h.trafficLights >= 0 && h.ticks >= 0 && h.sensorRate >= 1 && h.planBudget >= 1
+               && h.fleet >= 1;
+    }
+
+    uint64_t seed() const { return header.seed; }
+    int tick() const { return header.tick; }
+
+    Scenario scenario() const {
+        Scenario sc;
+        sc.dimX = header.dimX;
+        sc.dimY = header.dimY;
+        sc.movingCars = header.movingCars;
+        sc.movingBikes = header.movingBikes;
+        sc.parkedCars = header.parkedCars;
+        sc.stopSigns = header.stopSigns;
+        sc.trafficLights = header.trafficLights;
+        sc.ticks = header.ticks;
+        sc.minConfidenceThreshold = header.minConfidenceThreshold;
+        sc.sensorRate = header.sensorRate;
+        sc.planBudget = header.planBudget;
+        sc.fleet = header.fleet;
+        return sc;
+    }
+
+    static bool save(const string& path, const Scenario& sc, uint64_t seed, const GridWorld& world,
+                     const vector<SelfDrivingCar*>& cars, const vector<char>& running, int tick, const SimResult& result) {
+        SnapshotWriter w;
+        if (!w.open(path)) return false;
+        SnapshotHeader h;
+        memset(&h, 0, sizeof(h));
+        stamp(h.magic);
+        h.version = VERSION;
+        h.tick = tick;
+        h.seed = seed;
+        h.dimX = sc.dimX;
+        h.dimY = sc.dimY;
+        h.movingCars = sc.movingCars;
+        h.movingBikes = sc.movingBikes;
+        h.parkedCars = sc.parkedCars;
+        h.stopSigns = sc.stopSigns;
+        h.trafficLights = sc.trafficLights;
+        h.ticks = sc.ticks;
+        h.sensorRate = sc.sensorRate;
+        h.planBudget = sc.planBudget;
+        h.fleet = sc.fleet;
+        h.ticksToTarget = result.ticksToTarget;
+        h.outOfBounds = result.outOfBounds;
+        h.collisionTicks = result.collisionTicks;
+        h.maxCollisionsPerTick = result.maxCollisionsPerTick;
+        h.collisions = result.collisions;
+        h.crossings = result.crossings;
+        h.carCollisions = result.carCollisions;
+        for (int k = 0; k < 6; k++) h.objectCounters[k] = Object::getCounter((Kind)k);
+        h.sensorCounter = Sensor::getCounter();
+        h.minConfidenceThreshold = sc.minConfidenceThreshold;
+        w.pod(h);
+
+        const EntityStore& store = world.getStore();
+        w.array(store.x);
+        w.array(store.y);
+        w.array(store.speed);
+        w.array(store.dir);
+        w.array(store.kind);
+        w.array(store.handle);
+        w.array(store.lightPhase);
+        w.array(store.cellNext);
+        w.array(store.cellPrev);
+
+        vector<int> slots;
+        for (const SelfDrivingCar* car : cars) slots.push_back(car->getSlot());
+        w.array(slots);
+        w.array(running);
+        for (const SelfDrivingCar* car : cars) car->save(w);
+        return w.finish();
+    }
+
+    // ξαναχτιζει τον κοσμο (αδειο, με τις διαστασεις του snapshot) και τα οχηματα. καλειται μετα την
+    // begin_simulation ωστε τα οχηματα να παρουν τους ιδιους αισθητηρες με τη σειρα που πηραν αρχικα
+    bool restore(GridWorld& world, vector<SelfDrivingCar*>& cars, vector<char>& running, int& tick, SimResult& result) const {
+        SnapshotReader r(file.data(), file.size());
+        SnapshotHeader h;
+        r.pod(h);
+
+        EntityStore& store = world.restoreStore();
+        bool ok = r.array(store.x) && r.array(store.y) && r.array(store.speed) && r.array(store.dir)
+               && r.array(store.kind) && r.array(store.handle) && r.array(store.lightPhase)
+               && r.array(store.cellNext) && r.array(store.cellPrev);
+        size_t n = store.x.size();
+        for (size_t column : {store.y.size(), store.speed.size(), store.dir.size(), store.kind.size(), store.handle.size(),
+                              store.lightPhase.size(), store.cellNext.size(), store.cellPrev.size()}) {
+            ok = ok && column == n;
+        }
+        vector<int> slots;
+        ok = ok && r.array(slots) && r.array(running) && slots.size() == running.size() && (int)slots.size() == h.fleet;
+        // ο κοσμος εμπιστευεται οτι ξαναχτιζεται απο εδω: καθε SelfDrivingCar ειναι στο slots ακριβως μια φορα
+        // (αλλιως μενει χωρις αντικειμενο), καθε ειδος ειναι γνωστο, καθε θεση ειναι μεσα στον κοσμο και καθε
+        // δεσμος του ευρετηριου ειναι -1 ή slot του store
+        vector<char> listed(n, 0);
+        for (int s : slots) {
+            ok = ok && s >= 0 && s < (int)n && store.kind[s] == Kind::SelfDrivingCar && !listed[s];
+            if (ok) listed[s] = 1;
+        }
+        for (size_t s = 0; ok && s < n; s++) {
+            ok = (int)store.kind[s] <= (int)Kind::SelfDrivingCar
+                 && (store.kind[s] == Kind::SelfDrivingCar) == (listed[s] != 0)
+                 && store.x[s] >= 0 && store.x[s] < h.dimX && store.y[s] >= 0 && store.y[s] < h.dimY
+                 && store.cellNext[s] >= -1 && store.cellNext[s] < (int)n
+                 && store.cellPrev[s] >= -1 && store.cellPrev[s] < (int)n;
+        }
+        // καθε δεσμος μενει στο ιδιο κελι και ο αντιστροφος του δειχνει πισω. τοτε καθε κελι ειναι αλυσιδες που
+        // ξεκινανε απο slot με cellPrev -1, ή κυκλοι χωρις αρχη που τα for πανω στο cellNext δεν τελειωνουν ποτε.
+        // οι αλυσιδες πρεπει να περνανε απο ολα τα slot και να ειναι μια ανα κελι
+        auto sameCell = [&](int a, int b) { return store.x[a] == store.x[b] && store.y[a] == store.y[b]; };
+        for (size_t s = 0; ok && s < n; s++) {
+            int next = store.cellNext[s], prev = store.cellPrev[s];
+            ok = (next == -1 || (sameCell((int)s, next) && store.cellPrev[next] == (int)s))
+                 && (prev == -1 || (sameCell((int)s, prev) && store.cellNext[prev] == (int)s));
+        }
+        vector<uint64_t> headCells;
+        size_t chained = 0;
+        for (size_t s = 0; ok && s < n; s++) {
+            if (store.cellPrev[s] != -1) continue;
+            headCells.push_back((uint64_t)(uint32_t)store.x[s] << 32 | (uint32_t)store.y[s]);
+            for (int t = (int)s; t != -1; t = store.cellNext[t]) chained++;
+        }
+        sort(headCells.begin(), headCells.end());
+        ok = ok && chained == n && adjacent_find(headCells.begin(), headCells.end()) == headCells.end();
+        // τα στατικα μενουν ολα στον κοσμο, απο τα κινουμενα λειπουν οσα βγηκαν απο τα ορια
+        int perKind[6] = {0, 0, 0, 0, 0, 0};
+        for (size_t s = 0; ok && s < n; s++) perKind[(int)store.kind[s]]++;
+        ok = ok && perKind[(int)Kind::Bike] <= h.movingBikes && perKind[(int)Kind::Car] <= h.movingCars
+             && perKind[(int)Kind::ParkedCar] == h.parkedCars && perKind[(int)Kind::StopSign] == h.stopSigns
+             && perKind[(int)Kind::TrafficLight] == h.trafficLights;
+        if (!ok) return false;
+        store.owner.assign(n, nullptr);
+
+        // καθε αντικειμενο φτιαχνεται κανονικα και μετα παιρνει το slot του, με τον αριθμο του απο το store.
+        // τα μηνυματα δημιουργιας θα εδειχναν νεα αντικειμενα που δεν υπαρχουν, γι' αυτο κλεινουν εδω
+        unsigned savedCategories = Logger::categories;
+        Logger::categories &= ~(1u << (int)LogCat::Lifecycle);
+        for (size_t i = 0; i < slots.size(); i++) {
+            int s = slots[i];
+            SelfDrivingCar* car = world.create<SelfDrivingCar>(Position(store.x[s], store.y[s]), h.minConfidenceThreshold, (int)i);
+            world.adoptSlot(s, car);
+            cars.push_back(car);
+            ok = ok && car->load(r);
+        }
+        for (size_t s = 0; s < n; s++) {
+            if (store.kind[s] != Kind::SelfDrivingCar) world.adoptSlot((int)s, world.create(store.kind[s], Position(store.x[s], store.y[s])));
+        }
+        Logger::categories = savedCategories;
+
+        for (int k = 0; k < 6; k++) Object::setCounter((Kind)k, h.objectCounters[k]);
+        Sensor::setCounter(h.sensorCounter);
+        tick = h.tick;
+        store.lightClock = tick;
+        result.ticksToTarget = h.ticksToTarget;
+        result.outOfBounds = h.outOfBounds != 0;
+        result.collisionTicks = h.collisionTicks;
+        result.maxCollisionsPerTick = h.maxCollisionsPerTick;
+        result.collisions = h.collisions;
+        result.crossings = h.crossings;
+        result.carCollisions = h.carCollisions;
+        return ok && r.good();
+    }
+};
+
+//αποθηκευση ή συνεχεια μιας προσομοιωσης απο snapshot
+struct SnapshotOptions {
+    string savePath;                  // αν δοθει γραφεται snapshot πριν το saveTick (ή στο τελος αν δεν φτασει εκει)
+    int saveTick = -1;
+    const Snapshot* resume = nullptr; // συνεχεια απο αυτο αντι για νεο κοσμο
+};
+
+//οι αποφασεις που ξερει η πλοηγηση, στο trace γραφεται μονο η θεση τους στον πινακα
+const char* const traceDecisions[] = {"CONTINUE", "ACCELERATE", "DECELERATE", "TURN_N", "TURN_S", "TURN_E", "TURN_W",
+                                      "NEXT_TARGET", "STOP"};
+const int TRACE_DECISIONS = sizeof(traceDecisions) / sizeof(traceDecisions[0]);
+const unsigned char TRACE_OTHER_DECISION = 255;   // ακολουθει το κειμενο της αποφασης
+
+//αρχη του αρχειου trace, ακολουθουν οι στοχοι του οχηματος, οι εγγραφες των ticks, το ευρετηριο και το TraceFooter
+struct TraceHeader {
+    char magic[8];
+    uint32_t version;
+    int32_t dimX;
+    uint64_t seed;
+    int32_t dimY, planBudget, sensorRate, fleet;
+    double minConfidenceThreshold;
+};
+
+//τα τελευταια bytes του αρχειου: που ξεκιναει το ευρετηριο (μια θεση ανα tick) και απο ποιο tick
+struct TraceFooter {
+    uint64_t indexOffset;
+    int32_t firstTick;
+    int32_t ticks;
+};
+
+//ενα καταγεγραμμενο tick του πρωτου οχηματος
+struct TraceTick {
+    int tick;
+    bool scanned;
+    Position position;               // η θεση, η ταχυτητα και η κατευθυνση οταν πηρε την αποφαση
+    int speed;
+    Dir direction;
+    string decision;
+    vector<SensorReading> readings;  // οσα ειδαν οι αισθητηρες (κενο αν δεν σαρωσαν)
+    vector<SensorReading> fused;     // οσα περασαν απο το fusion
+};
+
+//γραφει σε καθε tick τις αναγνωσεις, το fusion, την αποφαση και την κατασταση του πρωτου οχηματος. οι εγγραφες
+//μαζευονται σε ενα buffer και γραφονται σειριακα. καθε αναγνωση κραταει μονο διαφορες: το handle απο το
+//προηγουμενο, τη θεση απο το οχημα, και οι ακεραιοι ειναι varint, ετσι μια αναγνωση πιανει ~10 bytes αντι για 24
+class TraceWriter {
+private:
+    SnapshotWriter out;
+    vector<unsigned char> buffer;
+    vector<uint64_t> index;     // θεση καθε tick στο αρχειο
+    int firstTick;
+
+    static const size_t FLUSH_BYTES = 1 << 16;
+
+    void varint(uint64_t v) {
+        while (v >= 0x80) {
+            buffer.push_back((unsigned char)(v | 0x80));
+            v >>= 7;
+        }
+        buffer.push_back((unsigned char)v);
+    }
+
+    void zigzag(int64_t v) { varint(((uint64_t)v << 1) ^ (uint64_t)(v >> 63)); }
+
+    void real(float v) {
+        unsigned char b[sizeof(float)];
+        memcpy(b, &v, sizeof(float));
+        buffer.insert(buffer.end(), b, b + sizeof(float));
+    }
+
+    void readings(const vector<SensorReading>& list, const Position& car) {
+        varint(list.size());
+        Handle previous = 0;
+        for (const auto& r : list) {
+            zigzag((int64_t)r.objectId - (int64_t)previous);
+            previous = r.objectId;
+            zigzag(r.position.x - car.x);
+            zigzag(r.position.y - car.y);
+            varint((uint32_t)r.distance);
+            real(r.confidence);
+            buffer.push_back(r.speed);
+            buffer.push_back((unsigned char)((int)r.objectType | (int)r.direction << 3 | (int)r.trafficLight << 6));
+        }
+    }
+
+    void flush() {
+        out.bytes(buffer.data(), buffer.size());
+        buffer.clear();
+    }
+
+public:
+    TraceWriter() : firstTick(0) {}
+
+    bool open(const string& path, const Scenario& sc, uint64_t seed) {
+        if (!out.open(path)) return false;
+        TraceHeader h;
+        memset(&h, 0, sizeof(h));
+        memcpy(h.magic, "SDCTRAC", 8);
+        h.version = 1;
+        h.seed = seed;
+        h.dimX = sc.dimX;
+        h.dimY = sc.dimY;
+        h.planBudget = sc.planBudget;
+        h.sensorRate = sc.sensorRate;
+        h.fleet = sc.fleet;
+        h.minConfidenceThreshold = sc.minConfidenceThreshold;
+        out.pod(h);
+        out.array(vector<Position>(sc.destinations.begin() + min<size_t>(1, sc.destinations.size()), sc.destinations.end()));
+        return true;
+    }
+
+    // μετα την αποφαση και πριν κινηθει το οχημα
+    void record(int tick, bool scanned, const SelfDrivingCar& car) {
+        if (index.empty()) firstTick = tick;
+        index.push_back(out.tell() + buffer.size());
+        Position pos = car.getPosition();
+        varint((uint32_t)tick);
+        buffer.push_back(scanned ? 1 : 0);
+        zigzag(pos.x);
+        zigzag(pos.y);
+        buffer.push_back((unsigned char)car.getSpeed());
+        buffer.push_back((unsigned char)car.getDirection());
+        const string& decision = car.getLastDecision();
+        int code = (int)(find(traceDecisions, traceDecisions + TRACE_DECISIONS, decision) - traceDecisions);
+        if (code < TRACE_DECISIONS) {
+            buffer.push_back((unsigned char)code);
+        } else {
+            buffer.push_back(TRACE_OTHER_DECISION);
+            varint(decision.size());
+            buffer.insert(buffer.end(), decision.begin(), decision.end());
+        }
+        readings(scanned ? car.getLastReadings() : vector<SensorReading>(), pos);
+        readings(car.getFusedReadings(), pos);
+        if (buffer.size() >= FLUSH_BYTES) flush();
+    }
+
+    int ticks() const { return (int)index.size(); }
+
+    bool finish() {
+        flush();
+        TraceFooter f;
+        f.indexOffset = out.tell();
+        f.firstTick = firstTick;
+        f.ticks = (int)index.size();
+        out.array(index);
+        out.pod(f);
+        return out.finish();
+    }
+};
+
+//διαβαζει ενα trace μεσω mmap. το ευρετηριο μενει στη μνημη του αρχειου, ετσι οποιο tick διαβαζεται
+//κατευθειαν χωρις να περασουν τα προηγουμενα
+class TraceReader {
+private:
+    MappedFile file;
+    TraceHeader header;
+    TraceFooter footer;
+    vector<Position> targets;
+    const uint64_t* index;
+
+    //διαβαζει μια εγγραφη, σε κομμενη ή χαλασμενη εγγραφη το ok γινεται false
+    struct Cursor {
+        const unsigned char* p;
+        const unsigned char* end;
+        bool ok;
+
+        unsigned char byte() {
+            if (p == end) {
+                ok = false;
+                return 0;
+            }
+            return *p++;
+        }
+
+        uint64_t varint() {
+            uint64_t v = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                unsigned char b = byte();
+                v |= (uint64_t)(b & 0x7F) << shift;
+                if (!(b & 0x80)) return v;
+            }
+            ok = false;
+            return 0;
+        }
+
+        int64_t zigzag() {
+            uint64_t v = varint();
+            return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+        }
+
+        float real() {
+            float v = 0;
+            if ((size_t)(end - p) < sizeof(float)) ok = false;
+            else {
+                memcpy(&v, p, sizeof(float));
+                p += sizeof(float);
+            }
+            return v;
+        }
+
+        void readings(vector<SensorReading>& list, const Position& car) {
+            list.clear();
+            uint64_t n = varint();
+            if (n > (uint64_t)(end - p)) {
+                ok = false;
+                return;
+            }
+            Handle previous = 0;
+            for (uint64_t i = 0; i < n && ok; i++) {
+                SensorReading r;
+                r.objectId = previous = (Handle)(previous + zigzag());
+                r.position.x = car.x + (int)zigzag();
+                r.position.y = car.y + (int)zigzag();
+                r.distance = (int)varint();
+                r.confidence = real();
+                r.speed = byte();
+                unsigned char packed = byte();
+                r.objectType = (Kind)(packed & 7);
+                r.direction = (Dir)(packed >> 3 & 7);
+                r.trafficLight = (Light)(packed >> 6);
+                list.push_back(r);
+            }
+        }
+    };
+
+public:
+    TraceReader() : index(nullptr) {}
+
+    bool open(const string& path) {
+        if (!file.open(path) || file.size() < sizeof(TraceHeader) + sizeof(TraceFooter)) return false;
+        SnapshotReader r(file.data(), file.size());
+        if (!r.pod(header) || memcmp(header.magic, "SDCTRAC", 8) != 0 || header.version != 1) return false;
+        if (!r.array(targets)) return false;
+        memcpy(&footer, file.data() + file.size() - sizeof(TraceFooter), sizeof(TraceFooter));
+        size_t n = 0;
+        if (!r.seek(footer.indexOffset) || !(index = r.array<uint64_t>(n)) || n != (size_t)footer.ticks) return false;
+        return true;
+    }
+
+    const TraceHeader& getHeader() const { return header; }
+    const vector<Position>& getTargets() const { return targets; }
+    int firstTick() const { return footer.firstTick; }
+    int ticks() const { return footer.ticks; }
+
+    // διαβαζει το i-οστο καταγεγραμμενο tick στο out, ξαναχρησιμοποιωντας τους πινακες του
+    bool read(int i, TraceTick& out) const {
+        if (i < 0 || i >= footer.ticks || index[i] >= footer.indexOffset) return false;
+        const unsigned char* base = (const unsigned char*)file.data();
+        Cursor c = {base + index[i], base + footer.indexOffset, true};
+        out.tick = (int)c.varint();
+        out.scanned = c.byte() != 0;
+        out.position.x = (int)c.zigzag();
+        out.position.y = (int)c.zigzag();
+        out.speed = c.byte();
+        out.direction = (Dir)c.byte();
+        unsigned char code = c.byte();
+        if (code < TRACE_DECISIONS) {
+            out.decision = traceDecisions[code];
+        } else {
+            if (code != TRACE_OTHER_DECISION) return false;
+            uint64_t n = c.varint();
+            if (n > (uint64_t)(c.end - c.p)) return false;
+            out.decision.assign((const char*)c.p, (size_t)n);
+            c.p += n;
+        }
+        c.readings(out.readings, out.position);
+        c.readings(out.fused, out.position);
+        return c.ok;
+    }
+};
+
+//τοποθετει τις οντοτητες ενος νεου κοσμου σε διαφορετικα κελια (δειγματοληψια χωρις επανατοποθετηση).
+//ο κοσμος και καθε --region χωριζονται σε λωριδες γραμμων (strata) των ~64K κελιων και καθε λωριδα παιρνει
+//μεριδιο των οντοτητων αναλογο με τα ελευθερα κελια της. οι λωριδες δειγματιζονται ανεξαρτητα σε ολα τα
+//νηματα, η καθε μια με δικους της μετρητες του Rng, ετσι ο κοσμος ειναι ιδιος με οσα νηματα κι αν φτιαχτει.
+//η οντοτητα e (αυξων αριθμος σε ολο τον κοσμο) παιρνει το κελι cell(e) και το ειδος kind(e), τα κελια
+//ειναι σε σειρα λωριδων και μεσα σε καθε λωριδα σε σειρα γραμμων
+class WorldGenerator {
+private:
+    static const int KINDS = 5;   // ολα τα ειδη εκτος απο SelfDrivingCar
+    static const int STRATUM_CELLS = 1 << 16;
+
+    struct Stratum {
+        int x0, y0, x1, y1;
+        int region;        // -1 για τον κοσμο εξω απο τις περιοχες
+        long long first;   // η πρωτη οντοτητα της
+        long long count;
+    };
+
+    const Scenario& sc;
+    vector<long long> reserved;   // κελια των οχηματων (y * dimX + x), χωρις διπλα
+    vector<Stratum> strata;
+    long long total;
+    long long kindStart[KINDS + 1];
+    long long stride;             // πρωτος προς το total, σκορπιζει τα ειδη σε ολες τις λωριδες
+    uint32_t key;
+    vector<Position> cells;
+    vector<Kind> kinds;
+
+    long long cellKey(int x, int y) const { return (long long)y * sc.dimX + x; }
+
+    // κελια του ορθογωνιου που δεν ανηκουν σε περιοχη (για τον υπολοιπο κοσμο) και δεν ειναι κρατημενα
+    long long available(const Stratum& s) const {
+        long long n = (long long)(s.x1 - s.x0 + 1) * (s.y1 - s.y0 + 1);
+        if (s.region < 0) {
+            for (const DensityRegion& r : sc.regions) {
+                long long w = min(s.x1, r.x1) - max(s.x0, r.x0) + 1;
+                long long h = min(s.y1, r.y1) - max(s.y0, r.y0) + 1;
+                if (w > 0 && h > 0) n -= w * h;
+            }
+        }
+        for (long long c : reserved) {
+            int x = (int)(c % sc.dimX), y = (int)(c / sc.dimX);
+            if (x >= s.x0 && x <= s.x1 && y >= s.y0 && y <= s.y1 && (s.region >= 0 || !inRegion(x, y))) n--;
+        }
+        return n;
+    }
+
+    bool inRegion(int x, int y) const {
+        for (const DensityRegion& r : sc.regions) {
+            if (r.contains(x, y)) return true;
+        }
+        return false;
+    }
+
+    // λωριδες του ορθογωνιου με ~STRATUM_CELLS κελια η καθε μια
+    void addStrata(int x0, int y0, int x1, int y1, int region) {
+        int rows = max(1, STRATUM_CELLS / (x1 - x0 + 1));
+        for (int y = y0; y <= y1; y += rows) {
+            strata.push_back({x0, y, x1, min(y1, y + rows - 1), region, 0, 0});
+        }
+    }
+
+    // μοιραζει target οντοτητες στις λωριδες [begin, end) αναλογα με τα ελευθερα κελια τους. οι μερικες
+    // αθροισεις στρογγυλευονται προς τα κατω, ετσι το αθροισμα βγαινει ακριβως target
+    void share(size_t begin, size_t end, long long target) {
+        vector<long long> space(end - begin);
+        long long all = 0;
+        for (size_t i = begin; i < end; i++) all += space[i - begin] = available(strata[i]);
+        long long acc = 0, done = 0;
+        for (size_t i = begin; i < end; i++) {
+            acc += space[i - begin];
+            long long upto = all > 0 ? (long long)((unsigned __int128)target * acc / all) : 0;
+            strata[i].count = upto - done;
+            done = upto;
+        }
+    }
+
+    // διαλεγει count διαφορετικα ελευθερα κελια της λωριδας j και τα ειδη τους. τα κελια κρατιουνται σε bitmap
+    // της λωριδας: τραβαω τυχαια κελια μεχρι να μαζευτουν, και οταν η λωριδα γεμιζει πανω απο τη μιση
+    // διαλεγω αντι για αυτα τα κελια που μενουν αδεια
+    void sample(int j) {
+        const Stratum& s = strata[j];
+        if (s.count == 0) return;
+        int width = s.x1 - s.x0 + 1;
+        int n = width * (s.y1 - s.y0 + 1);
+        uint64_t counter = (uint64_t)j << 32;
+        vector<uint64_t> taken((n + 63) / 64), skip((n + 63) / 64);
+        auto mark = [&](int x, int y) {
+            int i = (y - s.y0) * width + (x - s.x0);
+            skip[i >> 6] |= 1ULL << (i & 63);
+        };
+        if (s.region < 0) {
+            for (const DensityRegion& r : sc.regions) {
+                for (int y = max(s.y0, r.y0); y <= min(s.y1, r.y1); y++) {
+                    for (int x = max(s.x0, r.x0); x <= min(s.x1, r.x1); x++) mark(x, y);
+                }
+            }
+        }
+        for (long long c : reserved) {
+            int x = (int)(c % sc.dimX), y = (int)(c / sc.dimX);
+            if (x >= s.x0 && x <= s.x1 && y >= s.y0 && y <= s.y1) mark(x, y);
+        }
+        long long space = n;
+        for (uint64_t w : skip) space -= __builtin_popcountll(w);
+
+        bool fillFirst = s.count * 2 > space;
+        long long picks = fillFirst ? space - s.count : s.count;
+        if (fillFirst) {
+            for (size_t w = 0; w < taken.size(); w++) taken[w] = ~skip[w];
+            if (n & 63) taken.back() &= (1ULL << (n & 63)) - 1;
+        }
+        while (picks > 0) {
+            int i = Rng::below(key, counter++, n);
+            uint64_t bit = 1ULL << (i & 63);
+            if (skip[i >> 6] & bit) continue;
+            if (((taken[i >> 6] & bit) != 0) != fillFirst) continue;
+            taken[i >> 6] ^= bit;
+            picks--;
+        }
+        Position* out = &cells[s.first];
+        for (size_t w = 0; w < taken.size(); w++) {
+            for (uint64_t bits = taken[w]; bits; bits &= bits - 1) {
+                int i = (int)(w << 6) + __builtin_ctzll(bits);
+                *out++ = Position(s.x0 + i % width, s.y0 + i / width);
+            }
+        }
+
+        // η οντοτητα e ειναι η (e * stride) % total στη σειρα ποδηλατα, αυτοκινητα, ... και αφου stride και total
+        // ειναι πρωτοι μεταξυ τους καθε θεση αντιστοιχει σε ακριβως μια οντοτητα
+        Kind* kind = &kinds[s.first];
+        long long r = (long long)((unsigned __int128)s.first * stride % total);
+        for (long long k = 0; k < s.count; k++) {
+            int m = 0;
+            while (r >= kindStart[m + 1]) m++;
+            kind[k] = (Kind)m;
+            r += stride;
+            if (r >= total) r -= total;
+        }
+        // τα κελια μενουν σε σειρα γραμμων (ετσι η δημιουργια περναει τα tiles του ευρετηριου με τη σειρα),
+        // ανακατευω τα ειδη τους
+        for (long long k = s.count - 1; k > 0; k--) {
+            swap(kind[k], kind[Rng::below(key, counter++, (int)(k + 1))]);
+        }
+    }
+
+public:
+    // starts: οι αφετηριες των οχηματων, καμια οντοτητα δεν μπαινει εκει
+    WorldGenerator(const Scenario& sc, const vector<Position>& starts) : sc(sc) {
+        for (const Position& p : starts) {
+            if (p.x >= 0 && p.y >= 0 && p.x < sc.dimX && p.y < sc.dimY) reserved.push_back(cellKey(p.x, p.y));
+        }
+        sort(reserved.begin(), reserved.end());
+        reserved.erase(unique(reserved.begin(), reserved.end()), reserved.end());
+
+        int counts[KINDS] = {sc.movingBikes, sc.movingCars, sc.parkedCars, sc.stopSigns, sc.trafficLights};
+        kindStart[0] = 0;
+        for (int k = 0; k < KINDS; k++) kindStart[k + 1] = kindStart[k] + max(0, counts[k]);
+        total = kindStart[KINDS];
+        stride = max(1LL, (long long)(total * 0.6180339887));
+        while (__gcd(stride, max(1LL, total)) != 1) stride++;
+        key = Rng::key(Rng::Placement, 0x100);
+
+        // πρωτα οι περιοχες, οτι δεν χωραει σε αυτες (κελια κρατημενα για οχηματα) παει στον υπολοιπο κοσμο
+        long long outside = total;
+        for (size_t r = 0; r < sc.regions.size(); r++) {
+            const DensityRegion& region = sc.regions[r];
+            size_t begin = strata.size();
+            addStrata(region.x0, region.y0, region.x1, region.y1, (int)r);
+            long long space = 0;
+            for (size_t i = begin; i < strata.size(); i++) space += available(strata[i]);
+            long long target = min(region.target(), space);
+            share(begin, strata.size(), target);
+            outside -= target;
+        }
+        size_t begin = strata.size();
+        addStrata(0, 0, sc.dimX - 1, sc.dimY - 1, -1);
+        share(begin, strata.size(), outside);
+
+        long long first = 0;
+        for (Stratum& s : strata) {
+            s.first = first;
+            first += s.count;
+        }
+    }
+
+    // διαλεγει τα κελια ολων των λωριδων, στα νηματα του pool αν δοθει
+    void generate(ThreadPool* pool) {
+        cells.assign(total, Position());
+        kinds.assign(total, Kind::Bike);
+        function<void(int)> sampleOne = [this](int j) { sample(j); };
+        if (pool) pool->run((int)strata.size(), sampleOne);
+        else for (int j = 0; j < (int)strata.size(); j++) sampleOne(j);
+    }
+
+    long long size() const { return total; }
+    const Position& cell(long long e) const { return cells[e]; }
+    Kind kind(long long e) const { return kinds[e]; }
+};
+
+// στηνει νεο κοσμο για το σεναριο: το οχημα στην αρχη της διαδρομης του χρηστη, τα υπολοιπα αντικειμενα
+// και ο στολος σε τυχαια διαφορετικα κελια. η επιλογη των κελιων γινεται στα νηματα του pool
+void populate_world(const Scenario& sc, GridWorld& world, vector<SelfDrivingCar*>& cars, ThreadPool* pool) {
+    // δημιουργω το αυτοκινουμενο οχημα με της συντεταγμενες που εδωσε ο χρηστης, ο κοσμος το κραταει και το καταστρεφει
+    SelfDrivingCar* first = world.create<SelfDrivingCar>(Position(0, 0), sc.minConfidenceThreshold);
+    first->setPosition(sc.destinations[0].x, sc.destinations[0].y);
+    first->get_navigation().setPlanBudget(sc.planBudget);
+    world.addObject(first);
+    SelfDrivingCar& car = *first;
+    cars.push_back(first);
+    
+    // αν υπαρχουν παραπανω απο ενας στοχος τους περναω σε vector, αλλιως εχω ηδη φτασει και ο κοσμος μενει αδειος
+    if (sc.destinations.size() <= 1) return;
+    vector<Position> remainingTargets(sc.destinations.begin() + 1, sc.destinations.end());
+    car.setNavigationTargets(remainingTargets);
+    
+    // πρωτα οι αφετηριες του στολου, ωστε οι οντοτητες να μπουν σε αλλα κελια
+    vector<Position> starts(1, car.getPosition());
+    for (int i = 1; i < sc.fleet; i++) {
+        starts.push_back(random_position(Kind::SelfDrivingCar, i, sc.dimX, sc.dimY, starts));
+    }
+
+    // τα ποδηλατα, τα κινουμενα και τα παρκαρισμενα αυτοκινητα, τα σηματα STOP και τα φαναρια. μπαινουν στον κοσμο
+    // με τη σειρα των κελιων τους, ετσι το ευρετηριο κελιων γεμιζει tile προς tile
+    WorldGenerator generator(sc, starts);
+    generator.generate(pool);
+    world.reserve((int)generator.size() + sc.fleet);
+    for (long long e = 0; e < generator.size(); e++) world.spawn(generator.kind(e), generator.cell(e));
+
+    // ο υπολοιπος στολος: τυχαια αφετηρια και τοσοι τυχαιοι στοχοι οσοι και του πρωτου οχηματος
+    int targetCount = (int)sc.destinations.size() - 1;
+    for (int i = 1; i < sc.fleet; i++) {
+        Position start = starts[i];
+        SelfDrivingCar* other = world.create<SelfDrivingCar>(start, sc.minConfidenceThreshold, i);
+        vector<Position> targets;
+        for (int t = 0; t < targetCount; t++) {
+            targets.push_back(random_position(Kind::SelfDrivingCar, sc.fleet + (i - 1) * targetCount + t, sc.dimX, sc.dimY, start));
+        }
+        other->setNavigationTargets(targets);
+        other->get_navigation().setPlanBudget(sc.planBudget);
+        world.addObject(other);
+        cars.push_back(other);
+    }
+}
+
+// τρεχει ενα σεναριο με το δοσμενο seed. με renderer εμφανιζει τον κοσμο και την τελικη κατασταση οπως
+// πριν, χωρις renderer (batch) μονο μετραει
+SimResult run_simulation(const Scenario& sc, uint64_t seed, ThreadPool* sensorPool, FrameRenderer* renderer, int liveFps,
+                         const SnapshotOptions* snapshot = nullptr, TraceWriter* trace = nullptr) {
+    begin_simulation(seed);
+    SimResult result;
+
+    // δημιουργω τον κοσμο 
+    GridWorld world(sc.dimX, sc.dimY);
+    
+    vector<SelfDrivingCar*> cars;
+    vector<char> running;
+    int tick = 0;
+    if (snapshot && snapshot->resume) {
+        if (!snapshot->resume->restore(world, cars, running, tick, result)) {
+            cout << "ERROR: Snapshot is damaged" << endl;
+            result.damagedSnapshot = true;
+            return result;
+        }
+    } else {
+        populate_world(sc, world, cars, sensorPool);
+        running.assign(cars.size(), 1);
+    }
+    SelfDrivingCar& car = *cars[0];
+
+    if (!car.get_navigation().hasMoreTargets() && tick == 0) {
+        //εχω ηδη φτασει στοιν τελικο προορισμο και τερματιζω αφου κανω εκτυπωση της τελικης καταστασης
+        if (renderer) visualization_full(world, *renderer);
+        result.reachedAll = true;
+        result.ticksToTarget = 0;
+        result.finalPosition = car.getPosition();
+        result.carsReached = 1;
+        return result;
+    }
+    
+    // εκτυπωνωψ την πληρη εικονα του κοσμου με την συναρτηση visualization_full
+    if (renderer) visualization_full(world, *renderer);
+    
+    auto nextFrame = chrono::steady_clock::now();
+    int fleetSize = (int)cars.size();
+    int runningCount = (int)count(running.begin(), running.end(), 1);
+    CollisionDetector collisions;
+    bool scanned = false;
+    bool saved = false;
+    auto saveSnapshot = [&] {
+        saved = true;
+        if (!Snapshot::save(snapshot->savePath, sc, seed, world, cars, running, tick, result)) {
+            cout << "ERROR: Cannot write snapshot to " << snapshot->savePath << endl;
+        } else {
+            LOG(Lifecycle, Info) << "Snapshot of tick " << tick << " written to " << snapshot->savePath << "\n";
+        }
+    };
+
+    // καθε σταδιο τρεχει για ολο τον στολο μαζι: οι αισθητηρες, το fusion και η αποφαση μονο διαβαζουν τον κοσμο,
+    // αρα τα οχηματα μοιραζονται στα νηματα. με ενα οχημα το pool μοιραζει τους τρεις αισθητηρες του
+    ThreadPool* carPool = fleetSize > 1 ? sensorPool : nullptr;
+    ThreadPool* scanPool = fleetSize > 1 ? nullptr : sensorPool;
+    function<void(int)> senseOne = [&](int i) {
+        if (running[i]) cars[i]->collectSensorData(world, scanPool);
+    };
+    function<void(int)> fuseOne = [&](int i) {
+        if (running[i]) cars[i]->syncNavigationSystem(tick, scanned);
+    };
+    function<void(int)> decideOne = [&](int i) {
+        if (running[i]) cars[i]->decide(world);
+    };
+    auto forEachCar = [&](const function<void(int)>& f) {
+        if (carPool) carPool->run(fleetSize, f);
+        else for (int i = 0; i < fleetSize; i++) f(i);
+    };
+    
+    for (; tick < sc.ticks && runningCount > 0; tick++) {
+        if (snapshot && !snapshot->savePath.empty() && tick == snapshot->saveTick) saveSnapshot();
+        result.ticks = tick + 1;
+        PROFILE_TICK(tick);
+        PROFILE_SCOPE(Tick);
+        bool firstRunning = running[0];
+        
+        // ενημερωση των αντικειμενων του κοσμου 
+        {
+            PROFILE_SCOPE(UpdateAll);
+            world.updateAll(tick);
+        }
+        
+        {
+            PROFILE_SCOPE(Movers);
+            collisions.clear();
+            world.stepMovers(&collisions);
+        }
+        
+        // εδω τα αμαξια εκτελουν τις βασικες τους λειτουργιες(συλεγουν πληροφοριες απο τους αισθητηρες και ενεργοποιουν το σθστημα πλοηγησης)
+        // οι αισθητηρες σαρωνουν καθε sensorRate ticks, στα ενδιαμεσα η πλοηγηση δουλευει με τις προβλεψεις
+        scanned = tick % sc.sensorRate == 0;
+        if (scanned) {
+            PROFILE_SCOPE(Sensors);
+            forEachCar(senseOne);
+        }
+        {
+            PROFILE_SCOPE(Fusion);
+            forEachCar(fuseOne);
+        }
+        
+        //εμφανιζω τα στοιχεια των αιθητηρων του πρωτου οχηματος
+        if (firstRunning && scanned && Logger::enabled(LogCat::Sensors, LogLevel::Debug)) {
+            PROFILE_SCOPE(PrintReadings);
+            const vector<SensorReading>& readings = car.getLastReadings();
+            if (readings.empty()) {
+                Logger::out() << "  No objects detected\n";
+            } else {
+                for (const auto& reading : readings) {
+                    reading.print();
+                }
+            }
+        }
+        
+        if (firstRunning && Logger::enabled(LogCat::Fusion, LogLevel::Debug)) {
+            PROFILE_SCOPE(PrintReadings);
+            const vector<SensorReading>& fused = car.getFusedReadings();
+            const vector<SensorReading>& tracked = car.getTrackedReadings();
+            if (scanned) {
+                Logger::out() << "\nFused Sensor Readings:\n";
+                if (fused.empty()) {
+                    Logger::out() << "  No fused readings\n";
+                } else {
+                    for (const auto& reading : fused) {
+                        reading.print();
+                    }
+                }
+            }
+            if (tracked.size() > fused.size()) {
+                Logger::out() << "\nPredicted Tracks:\n";
+                for (size_t r = fused.size(); r < tracked.size(); r++) {
+                    tracked[r].print();
+                }
+            }
+        }
+        
+        //τα αμαξια εδω εκτελουν τις κινησεις για να κατευθηνθουν προς τον στοχο. οι αποφασεις παιρνονται
+        //παραλληλα, οι κινησεις γινονται με τη σειρα των οχηματων ωστε το αποτελεσμα να μην εξαρταται απο τα νηματα
+        {
+            PROFILE_SCOPE(Movement);
+            forEachCar(decideOne);
+            if (trace && firstRunning) trace->record(tick, scanned, car);
+            for (int i = 0; i < fleetSize; i++) {
+                Position from = cars[i]->getPosition();
+                if (running[i] && !cars[i]->applyDecision(world)) {
+                    running[i] = 0;
+                    runningCount--;
+                }
+                collisions.add(cars[i]->getHandle(), from, cars[i]->getPosition());
+            }
+        }
+
+        // συγκρουσεις ολων των κινησεων του tick, και των οχηματων που σταματησαν
+        {
+            PROFILE_SCOPE(Collisions);
+            int count = collisions.detect();
+            if (count > 0) {
+                result.collisions += count;
+                result.collisionTicks++;
+                result.maxCollisionsPerTick = max(result.maxCollisionsPerTick, count);
+                LOG(Collisions, Info) << "Tick " << tick << ": " << count << " collision" << (count > 1 ? "s" : "") << "\n";
+            }
+            for (const CollisionDetector::Event& e : collisions.getEvents()) {
+                if (e.crossing) result.crossings++;
+                if (handleKind(e.a) == Kind::SelfDrivingCar || handleKind(e.b) == Kind::SelfDrivingCar) result.carCollisions++;
+                LOG(Collisions, Debug) << "  " << kindName(handleKind(e.a)) << ":" << handleNum(e.a) << " and "
+                                       << kindName(handleKind(e.b)) << ":" << handleNum(e.b)
+                                       << (e.crossing ? " crossed at (" : " met at (") << e.cell.x << "," << e.cell.y << ")\n";
+            }
+        }
+        if (firstRunning) {
+            result.decisions[car.getLastDecision()]++;
+            if (result.ticksToTarget < 0 && !car.get_navigation().hasMoreTargets()) result.ticksToTarget = tick;
+            if (car.wentOutOfBounds()) result.outOfBounds = true;
+        }
+        
+        // εμφανιζω το κομματι του κοσμου που ειναι γυρο απο το οχημα
+        if (!renderer) continue;
+        if (liveFps > 0) {
+            {
+                PROFILE_SCOPE(Render);
+                renderer->renderLive(world, tick, Logger::out());
+            }
+            nextFrame += chrono::microseconds(1000000 / liveFps);
+            this_thread::sleep_until(nextFrame);
+        } else if (tick % 10 == 0 || tick == sc.ticks - 1) {
+            PROFILE_SCOPE(Render);
+            visualization_pov(world, car, *renderer, 5);
+        }
+    }
+
+    if (snapshot && !snapshot->savePath.empty() && !saved) saveSnapshot();
 
-    void accelerate() {
-        if (speed < 2)
-        speed ++;
+    result.reachedAll = !car.get_navigation().hasMoreTargets();
+    result.finalPosition = car.getPosition();
+    result.planner = car.get_navigation().getPlannerStats();
+    result.cars = fleetSize;
+    for (SelfDrivingCar* c : cars) {
+        if (!c->get_navigation().hasMoreTargets()) result.carsReached++;
     }
+    if (!renderer) return result;
+
+    LOG(Decisions, Info) << "Planner: " << result.planner.plans << " plans, " << result.planner.replans << " replans, "
+                         << result.planner.expansions << " expansions, " << result.planner.budgetHits << " ticks over budget\n";
     
-    void decelerate() {
-        if (speed > 0) {
-            speed--;
-        }
-    }
+    // εκτυπωνων προς τον χρηστη την τελικη θεση του αυτονομου αυτοκινητου στον κοσμο
+    cout << "Final Position: (" << car.getPosition().x << "," << car.getPosition().y << ")" << endl;
     
-    void turn(const string& newDir) {
-        if (direction != newDir) {
-            cout << "  Turning from " << direction << " to " << newDir << endl;
-            direction = newDir;
-        }
+    if (car.get_navigation().hasMoreTargets()) {
+        cout << "Remaining targets: Yes" << endl;
+    } else {
+        cout << "All targets reached!" << endl;
     }
-    
-    void collectSensorData(const GridWorld& world) {
-        lastReadings.clear();
-        
-        vector<SensorReading> cameraReadings = camera.scan(world, position.x, position.y, direction);
-        vector<SensorReading> lidarReadings = lidar.scan(world, position.x, position.y, direction);
-        vector<SensorReading> radarReadings = radar.scan(world, position.x, position.y, direction);
-        
-        lastReadings.insert(lastReadings.end(), cameraReadings.begin(), cameraReadings.end());
-        lastReadings.insert(lastReadings.end(), lidarReadings.begin(), lidarReadings.end());
-        lastReadings.insert(lastReadings.end(), radarReadings.begin(), radarReadings.end());
+    if (fleetSize > 1) {
+        cout << "Fleet: " << result.carsReached << "/" << fleetSize << " vehicles reached all targets" << endl;
     }
+    cout << "Collisions: " << result.collisions << " (" << result.crossings << " crossing paths), "
+         << result.carCollisions << " with autonomous vehicles, at most " << result.maxCollisionsPerTick
+         << " in a tick (" << result.collisionTicks << " ticks)" << endl;
     
-    void syncNavigationSystem() {
-        fusedReadings = navigation.processSensorData(lastReadings);
-    }
+    if (liveFps == 0) visualization_full(world, *renderer);
     
-    // σηναρτηση για την εκτελεση των αποφασεων 
-    bool executeMovement(GridWorld& world) {
-        string decision = navigation.makeDecision(position, direction, fusedReadings, speed);
-        
-        cout << "  Decision: " << decision << endl;
-        
-        if (decision == "ACCELERATE") {
-            accelerate();
-        } else if (decision == "DECELERATE") {
-            decelerate();
-        } else if (decision == "TURN_E") {
-            turn("E");
-        } else if (decision == "TURN_W") {
-            turn("W");
-        } else if (decision == "TURN_N") {
-            turn("N");
-        } else if (decision == "TURN_S") {
-            turn("S");
-        } else if (decision == "NEXT_TARGET") {
-            navigation.nextTarget();
-            return true;
-        } else if (decision == "STOP") {
-            speed = 0;
-            cout << "  Final destination reached!" << endl;
+    return result;
+}
+
+// ξανατρεχει την πλοηγηση του πρωτου οχηματος πανω στις καταγεγραμμενες αναγνωσεις, χωρις κοσμο και αισθητηρες,
+// και μετραει οσες αποφασεις διαφερουν απο την καταγραφη. η θεση του οχηματος βγαινει παντα απο το trace,
+// ετσι μια αλλαγη στη λογικη των αποφασεων δοκιμαζεται στα ιδια δεδομενα με ταχυτητα αναγνωσης αρχειου
+bool replay_trace(const TraceReader& trace) {
+    if (trace.firstTick() != 0) {
+        cout << "ERROR: Trace starts at tick " << trace.firstTick() << ", replay needs a trace recorded from tick 0" << endl;
+        return false;
+    }
+    const TraceHeader& h = trace.getHeader();
+    NavigationSystem navigation(h.minConfidenceThreshold);
+    navigation.setGPSTargets(trace.getTargets());
+    navigation.setPlanBudget(h.planBudget);
+    navigation.setWorldSize(h.dimX, h.dimY);
+
+    TraceTick t;
+    vector<SensorReading> fused, tracked;
+    int decisionsDiffer = 0;
+    int fusedDiffer = 0;
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < trace.ticks(); i++) {
+        if (!trace.read(i, t)) {
+            cout << "ERROR: Trace is damaged at record " << i << endl;
             return false;
         }
-        
-        // Move the car
-        if (speed > 0) {
-            if (!move(world)) {
-                cout << "!!! CAR WENT OUT OF BOUNDS !!!" << endl;
-                return false;
+        if (t.scanned) navigation.processSensorData(t.readings, t.tick, fused);
+        else fused.clear();
+        tracked = fused;
+        navigation.predictTracks(t.position, t.tick, tracked);
+        int speed = t.speed;
+        string decision = navigation.makeDecision(t.position, t.direction, tracked, speed);
+        if (decision == "NEXT_TARGET") navigation.nextTarget();
+
+        if (fused.size() != t.fused.size()
+            || (!fused.empty() && memcmp(fused.data(), t.fused.data(), fused.size() * sizeof(SensorReading)) != 0)) {
+            fusedDiffer++;
+        }
+        if (decision != t.decision) {
+            if (decisionsDiffer++ == 0) {
+                cout << "First difference at tick " << t.tick << ": recorded " << t.decision << ", replayed " << decision << endl;
             }
+            LOG(Decisions, Debug) << "Tick " << t.tick << ": recorded " << t.decision << ", replayed " << decision << "\n";
         }
-        
-        return true;
     }
-    
-    const vector<SensorReading>& getLastReadings() const {
-        return lastReadings;
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << "Replayed " << trace.ticks() << " ticks in " << seconds * 1000 << " ms ("
+         << (long long)(trace.ticks() / max(seconds, 1e-9)) << " ticks/s)" << endl;
+    if (decisionsDiffer == 0) cout << "All decisions match the trace" << endl;
+    else cout << decisionsDiffer << " of " << trace.ticks() << " decisions differ" << endl;
+    if (fusedDiffer > 0) cout << fusedDiffer << " ticks with different fused readings" << endl;
+    return true;
+}
+
+// εμφανιζει ενα tick του trace, το ευρετηριο δινει τη θεση του χωρις να διαβαστουν τα προηγουμενα
+bool show_trace_tick(const TraceReader& trace, int tick) {
+    TraceTick t;
+    if (!trace.read(tick - trace.firstTick(), t)) {
+        cout << "ERROR: Tick " << tick << " is not in the trace (ticks " << trace.firstTick() << " to "
+             << trace.firstTick() + trace.ticks() - 1 << ")" << endl;
+        return false;
     }
-    
-    const vector<SensorReading>& getFusedReadings() const {
-        return fusedReadings;
+    cout << "Tick " << t.tick << ": vehicle at (" << t.position.x << "," << t.position.y << "), heading "
+         << dirName(t.direction) << " at " << t.speed << " units/tick" << endl;
+    cout << "\nSensor Readings:\n";
+    if (!t.scanned) cout << "  No scan this tick\n";
+    else if (t.readings.empty()) cout << "  No objects detected\n";
+    for (const auto& reading : t.readings) reading.print();
+    cout << "\nFused Sensor Readings:\n";
+    if (t.fused.empty()) cout << "  No fused readings\n";
+    for (const auto& reading : t.fused) reading.print();
+    cout << "\nDecision: " << t.decision << endl;
+    return true;
+}
+
+//ενα αποτελεσμα της σουιτας μετρησεων
+struct BenchResult {
+    string name;
+    int side;
+    double density;
+    int entities;
+    long long iterations;
+    double nsPerOp;
+    double itemsPerSec;
+    double allocsPerOp;
+};
+
+//streambuf που πεταει οτι του γραφουν, για να μετραω το visualization_full χωρις το τερματικο
+class NullBuffer : public streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    streamsize xsputn(const char*, streamsize n) override { return n; }
+};
+
+//ενας κοσμος για μετρησεις: side x side κελια με density οντοτητες ανα κελι και το οχημα στο κεντρο
+struct BenchWorld {
+    unique_ptr<GridWorld> world;
+    unique_ptr<SelfDrivingCar> car;
+    vector<unique_ptr<SelfDrivingCar>> others;   // τα υπολοιπα οχηματα του στολου, εκτος κοσμου οπως και το car
+
+    void build(int side, double density, int fleetSize = 1) {
+        others.clear();
+        car.reset();
+        world.reset();
+        begin_simulation(1);
+        world.reset(new GridWorld(side, side));
+        car.reset(new SelfDrivingCar(Position(side / 2, side / 2)));
+        car->setPosition(side / 2, side / 2);
+        car->setNavigationTargets({Position(side - 1, side / 2), Position(side / 2, side - 1)});
+        // τα υπολοιπα οχηματα σε μια διαγωνιο γυρω απο το κεντρο, το καθενα με δικους του στοχους
+        for (int i = 1; i < fleetSize; i++) {
+            int x = side / 4 + i * side / (2 * fleetSize), y = side - 1 - x;
+            SelfDrivingCar* other = new SelfDrivingCar(Position(x, y), 0.4, i);
+            other->setPosition(x, y);
+            other->setNavigationTargets({Position(side - 1, y), Position(x, 0)});
+            others.emplace_back(other);
+        }
+        int entities = (int)(side * (double)side * density);
+        uint32_t placement = Rng::key(Rng::Placement, 0);
+        for (int i = 0; i < entities; i++) {
+            Position pos(Rng::below(placement, 2 * (uint64_t)i, side), Rng::below(placement, 2 * (uint64_t)i + 1, side));
+            world->spawn(bench_kind(i), pos);
+        }
     }
-    
-    string getType() const override { return "SelfDrivingCar"; }
 };
 
-//συναρτηση για την εκτηποση του κοσμου
-void visualization_full(const GridWorld& world, const SelfDrivingCar& car) {
-    int dimX = world.getDimX();
-    int dimY = world.getDimY();
-    
-    //βαζω στα ορια τον χαρακτηρα "Χ" οπως λεει η εκγωνηση της εργασιας 
-    cout << "X";
-    for (int x = 0; x < dimX; x++) cout << "X";
-    cout << "X" << endl;
-    
-    for (int y = dimY - 1; y >= 0; y--) {
-        cout << "X";
-        for (int x = 0; x < dimX; x++) {
-            Position pos(x, y);
-            Position carPos = car.getPosition();
-            
-            //στην θεση του αυτονομου αυτοκινητου βαζω το συμβολο @ συμφωνα με την εκφωνηση
-            if (pos.x == carPos.x && pos.y == carPos.y) {
-                cout << "@";
-                continue;
-            }
-            
-            Object* obj = world.getObjectAt(x, y);
-            if (obj) {
-                cout << obj->getGlyph();
-            } else {
-                cout << ".";
-            }
+//ενα tick σε σταθερη κατασταση πανω σε BenchWorld, με τα σταδια της run_simulation: με ενα οχημα το pool
+//μοιραζει τους αισθητηρες του, με στολο τα οχηματα. τα οχηματα αποφασιζουν χωρις να κινηθουν, ετσι μετα
+//το ζεσταμα ολοι οι buffers εχουν τη χωρητικοτητα τους και ο planner δεν ανοιγει νεα tiles. ενα τετοιο
+//tick δεν πρεπει να δεσμευει τιποτα
+struct SteadyTick {
+    enum Stage { UpdateAll, Movers, Sensors, Fusion, Decide, Collisions, STAGES };
+
+    BenchWorld& bw;
+    vector<SelfDrivingCar*> fleet;
+    ThreadPool* carPool;
+    ThreadPool* scanPool;
+    CollisionDetector collisions;
+    function<void(int)> senseOne, fuseOne, decideOne;
+    int tick = 0;
+
+    static const char* stageName(int stage) {
+        static const char* names[] = {"updateAll", "stepMovers", "collectSensorData", "syncNavigationSystem", "decide",
+                                      "collisions"};
+        return names[stage];
+    }
+
+    // ξαναχτιζει τον κοσμο με fleetSize οχηματα και τον φερνει σε σταθερη κατασταση
+    SteadyTick(BenchWorld& world, int side, double density, int fleetSize, ThreadPool* pool) : bw(world) {
+        bw.build(side, density, fleetSize);
+        fleet.push_back(bw.car.get());
+        for (auto& other : bw.others) fleet.push_back(other.get());
+        carPool = fleetSize > 1 ? pool : nullptr;
+        scanPool = fleetSize > 1 ? nullptr : pool;
+        senseOne = [this](int i) { fleet[i]->collectSensorData(*bw.world, scanPool); };
+        fuseOne = [this](int i) { fleet[i]->syncNavigationSystem(tick, true); };
+        decideOne = [this](int i) { fleet[i]->decide(*bw.world); };
+        // ο planner τελειωνει τη διαδρομη στο ζεσταμα
+        for (SelfDrivingCar* c : fleet) c->get_navigation().setPlanBudget(INT_MAX);
+        for (int i = 0; i < 64; i++) run();
+    }
+
+    void forEachCar(const function<void(int)>& f) {
+        if (carPool) carPool->run((int)fleet.size(), f);
+        else for (int i = 0; i < (int)fleet.size(); i++) f(i);
+    }
+
+    void stage(int s) {
+        switch (s) {
+        case UpdateAll: bw.world->updateAll(tick); break;
+        case Movers:
+            collisions.clear();
+            bw.world->stepMovers(&collisions);
+            break;
+        case Sensors: forEachCar(senseOne); break;
+        case Fusion: forEachCar(fuseOne); break;
+        case Decide: forEachCar(decideOne); break;
+        case Collisions:
+            for (SelfDrivingCar* c : fleet) collisions.add(c->getHandle(), c->getPosition(), c->getPosition());
+            collisions.detect();
+            break;
         }
-        cout << "X" << endl;
     }
-    
 
-    cout << "X";
-    for (int x = 0; x < dimX; x++) cout << "X";
-    cout << "X" << endl;
+    long long run() {
+        for (int s = 0; s < STAGES; s++) stage(s);
+        tick++;
+        return bw.world->getStore().size();
+    }
+};
+
+// τρεχει το op μεχρι να μαζευτουν τουλαχιστον minMs χρονου. το op επιστρεφει ποσα items επεξεργαστηκε.
+// με resetEvery > 0 καλει πρωτα το reset (εκτος χρονομετρησης) και μετα το πολυ resetEvery φορες το op,
+// για μετρησεις που αλλαζουν τον κοσμο (οι κινουμενοι βγαινουν απο τα ορια)
+template <class Op>
+BenchResult bench_measure(const string& name, int side, double density, int entities, Op op,
+                          const function<void()>& reset = nullptr, int resetEvery = 0, double minMs = 50) {
+    auto elapsed = [](chrono::steady_clock::time_point a, chrono::steady_clock::time_point b) {
+        return chrono::duration<double, nano>(b - a).count();
+    };
+    if (reset) reset();
+    op(); // ζεσταμα, δεν μετραει
+
+    long long iterations = 0, items = 0, allocations = 0;
+    double ns = 0;
+    long long batch = 1;
+    while (ns < minMs * 1e6) {
+        if (reset) {
+            reset();
+            batch = resetEvery;
+        }
+        long long allocsBefore = allocationCount.load(memory_order_relaxed);
+        auto t0 = chrono::steady_clock::now();
+        for (long long i = 0; i < batch; i++) items += op();
+        auto t1 = chrono::steady_clock::now();
+        allocations += allocationCount.load(memory_order_relaxed) - allocsBefore;
+        ns += elapsed(t0, t1);
+        iterations += batch;
+        if (!reset) batch *= 2;
+    }
+
+    BenchResult r;
+    r.name = name;
+    r.side = side;
+    r.density = density;
+    r.entities = entities;
+    r.iterations = iterations;
+    r.nsPerOp = ns / iterations;
+    r.itemsPerSec = items / (ns / 1e9);
+    r.allocsPerOp = (double)allocations / iterations;
+    return r;
 }
 
-// υλοποιω μια συναρτηση για την μερικη οπτικοποιηση  και γινεται σε καθε κυκλο (tick)
-void visualization_pov(const GridWorld& world, const SelfDrivingCar& car, int radius = 5) {
-    Position carPos = car.getPosition();
-    
-    cout << "\n=== CAR'S POINT OF VIEW (radius: " << radius << ") ===" << endl;
-    cout << "Car at (" << carPos.x << "," << carPos.y << ") facing " << car.getDirection() << endl;
-    
-    for (int y = carPos.y + radius; y >= carPos.y - radius; y--) {
-        for (int x = carPos.x - radius; x <= carPos.x + radius; x++) {
-            if (!world.inBounds(x, y)) {
-                cout << " ";
-                continue;
+//ιδια διαταξη γυρω απο την καμερα, με το οχημα στην τελευταια στηλη ενος tile 8x8 και στη μεση ενος αλλου:
+//η οπτικη επαφη δεν πρεπει να εξαρταται απο το πού πεφτουν τα ορια των tiles. επιστρεφει true αν συμφωνουν
+bool check_sight_alignment() {
+    // το (1,3) κρυβεται πισω απο το (0,1), που ειναι στη στηλη του οχηματος και εξω απο το κουτι της καμερας
+    const Position layout[] = {Position(0, 1), Position(1, 3), Position(0, -1), Position(2, -2), Position(1, 1),
+                               Position(3, 2), Position(2, 0), Position(3, 0), Position(3, -3)};
+    vector<Position> seen[2];
+    const int carXs[2] = {15, 19};   // x % 8 == 7 και x % 8 == 3
+    const int carY = 20;
+    for (int k = 0; k < 2; k++) {
+        GridWorld world(40, 40);
+        for (const Position& offset : layout) world.spawn(Kind::ParkedCar, Position(carXs[k] + offset.x, carY + offset.y));
+        CameraSensor camera(0, 0);
+        vector<SensorReading> readings;
+        camera.scan(world, carXs[k], carY, Dir::E, readings);
+        for (const SensorReading& r : readings) seen[k].push_back(Position(r.position.x - carXs[k], r.position.y - carY));
+        sort(seen[k].begin(), seen[k].end(), [](const Position& a, const Position& b) {
+            return a.x != b.x ? a.x < b.x : a.y < b.y;
+        });
+    }
+    return seen[0] == seen[1];
+}
+
+//μετραει καθε σταδιο της προσομοιωσης σε διαφορα μεγεθη και πυκνοτητες και γραφει τα αποτελεσματα
+//σε JSON (στο stdout αν path ειναι "-") ωστε να συγκρινονται builds μεταξυ τους. επιστρεφει false
+//αν η οπτικη επαφη εξαρταται απο τα tiles
+bool bench_suite(const string& path) {
+    const int sides[] = {64, 256, 1024};
+    const double densities[] = {0.05, 0.25};
+    vector<BenchResult> results;
+
+    unsigned savedCategories = Logger::categories;
+    Logger::categories = 0;
+    bool sightAligned = check_sight_alignment();
+    for (int side : sides) {
+        for (double density : densities) {
+            BenchWorld bw;
+            bw.build(side, density);
+            int entities = bw.world->getStore().size();
+            Position center(side / 2, side / 2);
+            int tick = 0;
+            auto rebuild = [&] {
+                bw.build(side, density);
+                tick = 0;
+            };
+
+            uint32_t probeKey = Rng::key(Rng::Placement, 1000);
+            vector<Position> probes(4096);
+            for (int i = 0; i < (int)probes.size(); i++) {
+                probes[i] = Position(Rng::below(probeKey, 2 * (uint64_t)i, side), Rng::below(probeKey, 2 * (uint64_t)i + 1, side));
             }
-            
-            if (x == carPos.x && y == carPos.y) {
-                cout << "@";
-            } else {
-                Object* obj = world.getObjectAt(x, y);
-                if (obj) {
-                    cout << obj->getGlyph();
-                } else {
-                    cout << ".";
+            int probe = 0;
+            results.push_back(bench_measure("getObjectAt", side, density, entities, [&] {
+                const Position& p = probes[probe++ & 4095];
+                return bw.world->getObjectAt(p.x, p.y) ? 1LL : 0LL;
+            }));
+
+            results.push_back(bench_measure("updateAll", side, density, entities, [&] {
+                bw.world->updateAll(tick++);
+                return (long long)bw.world->getStore().size();
+            }));
+
+            results.push_back(bench_measure("moveMovers", side, density, entities, [&] {
+                bw.world->stepMovers();
+                return (long long)bw.world->getStore().size();
+            }, rebuild, 16));
+
+            // οι διαδρομες ενος tick των κινουμενων, ξανα και ξανα απο το broad phase
+            CollisionDetector collisions;
+            rebuild();
+            bw.world->stepMovers(&collisions);
+            results.push_back(bench_measure("detectCollisions", side, density, entities, [&] {
+                collisions.detect();
+                return (long long)bw.world->getStore().size();
+            }));
+            // οι υπολοιπες μετρησεις δεν αλλαζουν τον κοσμο
+            rebuild();
+            GridWorld& world = *bw.world;
+            SelfDrivingCar& car = *bw.car;
+
+            vector<SensorReading> buffer;
+            Sensor* sensors[3] = {&car.get_camera(), &car.get_lidar(), &car.get_radar()};
+            const char* sensorNames[3] = {"cameraScan", "lidarScan", "radarScan"};
+            for (int k = 0; k < 3; k++) {
+                results.push_back(bench_measure(sensorNames[k], side, density, entities, [&] {
+                    buffer.clear();
+                    sensors[k]->scan(world, center.x, center.y, Dir::E, buffer);
+                    return (long long)buffer.size();
+                }));
+            }
+
+            // ακτινες σε αποσταση radar απο τυχαια σημεια, ενα load και 64 ακτινες καθε φορα
+            LineOfSight sight;
+            const int rayRange = 12;
+            long long sightClear = 0;
+            results.push_back(bench_measure("lineOfSight", side, density, entities, [&] {
+                const Position& from = probes[probe++ & 4095];
+                sight.load(world, from.x - rayRange, from.y - rayRange, from.x + rayRange, from.y + rayRange);
+                for (int k = 0; k < 64; k++) {
+                    const Position& to = probes[(probe + k) & 4095];
+                    int tx = min(side - 1, max(0, from.x + to.x % (2 * rayRange + 1) - rayRange));
+                    int ty = min(side - 1, max(0, from.y + to.y % (2 * rayRange + 1) - rayRange));
+                    sightClear += sight.clear(from.x, from.y, tx, ty);
                 }
+                return 64LL;
+            }));
+
+            car.collectSensorData(world);
+            vector<SensorReading> readings = car.getLastReadings();
+            SensorFusionEngine engine;
+            vector<SensorReading> fused;
+            int fuseTick = 0;
+            results.push_back(bench_measure("fuseSensorData", side, density, entities, [&] {
+                engine.fuseSensorData(readings, fuseTick++, fused);
+                return (long long)readings.size();
+            }));
+
+            NavigationSystem& navigation = car.get_navigation();
+            results.push_back(bench_measure("makeDecision", side, density, entities, [&] {
+                int speed = 1;
+                return navigation.makeDecision(center, Dir::E, fused, speed).empty() ? 0LL : 1LL;
+            }));
+
+            FrameRenderer renderer;
+            NullBuffer nullBuffer;
+            streambuf* savedBuffer = cout.rdbuf(&nullBuffer);
+            Logger::categories = 1u << (int)LogCat::Render;
+            results.push_back(bench_measure("visualization_full", side, density, entities, [&] {
+                visualization_full(world, renderer);
+                return (long long)side * side;
+            }));
+            Logger::categories = 0;
+            cout.rdbuf(savedBuffer);
+
+            // 1024 ποδηλατα μπαινουν και βγαινουν, ο κοσμος μενει οπως ηταν
+            vector<Object*> spawned;
+            spawned.reserve(1024);
+            results.push_back(bench_measure("spawnDespawn", side, density, entities, [&] {
+                spawned.clear();
+                for (int i = 0; i < 1024; i++) spawned.push_back(world.spawn<Bike>(probes[i]));
+                for (Object* obj : spawned) world.removeObject(obj);
+                return 1024LL;
+            }));
+
+            // ενας νεος κοσμος με τις ιδιες οντοτητες απο τον WorldGenerator, ολες σε διαφορετικα κελια
+            Scenario generated;
+            generated.dimX = generated.dimY = side;
+            generated.movingBikes = entities * 8 / 20;
+            generated.movingCars = entities * 6 / 20;
+            generated.stopSigns = entities / 20;
+            generated.trafficLights = entities / 20;
+            generated.parkedCars = entities - generated.movingBikes - generated.movingCars - generated.stopSigns - generated.trafficLights;
+            generated.minConfidenceThreshold = 0.4;
+            generated.planBudget = 20000;
+            generated.fleet = 1;
+            generated.destinations = {center, Position(side - 1, side / 2)};
+            results.push_back(bench_measure("generateWorld", side, density, entities, [&] {
+                GridWorld fresh(side, side);
+                vector<SelfDrivingCar*> freshCars;
+                populate_world(generated, fresh, freshCars, nullptr);
+                return (long long)fresh.objectCount();
+            }));
+
+            // αυτες αλλαζουν τον κοσμο και τον ξαναχτιζουν, απο εδω και περα μονο μεσα απο το bw
+            // ολοκληρο tick οπως στην run_simulation: κοσμος, κινουμενοι, αισθητηρες, fusion, αποφαση, κινηση
+            results.push_back(bench_measure("fullTick", side, density, entities, [&] {
+                bw.world->updateAll(tick);
+                bw.world->stepMovers();
+                bw.car->collectSensorData(*bw.world);
+                bw.car->syncNavigationSystem(tick, true);
+                bw.car->executeMovement(*bw.world);
+                tick++;
+                return (long long)bw.world->getStore().size();
+            }, rebuild, 16));
+
+            // ο ιδιος κυκλος σε σταθερη κατασταση (δες SteadyTick), χωρις και με νηματα για τους αισθητηρες και
+            // για στολο. αν δεσμευει μνημη το λεει το --checkAllocs, εδω μετραει μονο ο χρονος
+            ThreadPool pool(3);
+            const pair<const char*, int> steadyRuns[] = {{"steadyTick", 1}, {"steadyTickPool", 1}, {"steadyTickFleet", 8}};
+            for (const auto& run : steadyRuns) {
+                SteadyTick steady(bw, side, density, run.second, run.first == steadyRuns[0].first ? nullptr : &pool);
+                results.push_back(bench_measure(run.first, side, density, entities, [&] { return steady.run(); }));
             }
         }
+    }
+    Logger::categories = savedCategories;
+
+    ostringstream json;
+    json << fixed << setprecision(2);
+    json << "{\n  \"kernel\": \"" << ScanKernel::isaName(ScanKernel::active) << "\",\n  \"allocations_counted\": "
+         << (allocationsCounted ? "true" : "false") << ",\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        json << "    {\"name\": \"" << r.name << "\", \"side\": " << r.side << ", \"density\": " << r.density
+             << ", \"entities\": " << r.entities << ", \"iterations\": " << r.iterations
+             << ", \"ns_per_op\": " << r.nsPerOp << ", \"items_per_s\": " << r.itemsPerSec;
+        if (allocationsCounted) json << ", \"allocs_per_op\": " << r.allocsPerOp;
+        json << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    json << "  ]\n}\n";
+
+    if (path == "-") {
+        cout << json.str();
+        return sightAligned;
+    }
+    ofstream file(path);
+    file << json.str();
+    cout << "Benchmark suite: " << results.size() << " results written to " << path << endl;
+    cout << fixed << setprecision(1);
+    for (const BenchResult& r : results) {
+        cout << "  " << left << setw(20) << r.name << right << setw(6) << r.side << setw(6) << setprecision(2) << r.density
+             << setw(14) << setprecision(1) << r.nsPerOp << " ns/op";
+        if (allocationsCounted) cout << setw(10) << setprecision(2) << r.allocsPerOp << " allocs/op";
         cout << endl;
     }
+    cout.unsetf(ios::fixed);
+    cout << setprecision(6);
+    if (!allocationsCounted) cout << "WARNING: built without -DALLOC_COUNTING, allocations were not counted" << endl;
+    if (!sightAligned) cout << "ERROR: Camera readings depend on the car's position within an 8x8 tile" << endl;
+    return sightAligned;
+}
+
+//ελεγχος οτι ενα tick σε σταθερη κατασταση δεν δεσμευει μνημη, για ενα οχημα χωρις και με νηματα και για στολο
+//σε δυο μεγεθη και πυκνοτητες. τυπωνει καθε σταδιο που δεσμευσε και επιστρεφει false αν υπαρχει εστω ενα.
+//θελει build με -DALLOC_COUNTING, αλλιως δεν υπαρχει τι να μετρησει
+bool check_allocs() {
+    if (!allocationsCounted) {
+        cout << "ERROR: --checkAllocs needs a build with -DALLOC_COUNTING" << endl;
+        return false;
+    }
+    const int sides[] = {64, 256};
+    const double densities[] = {0.05, 0.25};
+    const int TICKS = 16;
+    unsigned savedCategories = Logger::categories;
+    Logger::categories = 0;
+    ThreadPool pool(3);
+    int failures = 0, checks = 0;
+    for (int side : sides) {
+        for (double density : densities) {
+            const pair<const char*, int> runs[] = {{"one car", 1}, {"one car with sensor pool", 1}, {"fleet of 8", 8}};
+            for (const auto& run : runs) {
+                BenchWorld bw;
+                SteadyTick steady(bw, side, density, run.second, run.first == runs[0].first ? nullptr : &pool);
+                long long made[SteadyTick::STAGES] = {};
+                for (int t = 0; t < TICKS; t++) {
+                    for (int s = 0; s < SteadyTick::STAGES; s++) {
+                        long long before = allocationCount.load(memory_order_relaxed);
+                        steady.stage(s);
+                        made[s] += allocationCount.load(memory_order_relaxed) - before;
+                    }
+                    steady.tick++;
+                }
+                for (int s = 0; s < SteadyTick::STAGES; s++) {
+                    checks++;
+                    if (made[s] == 0) continue;
+                    failures++;
+                    cout << "ERROR: " << SteadyTick::stageName(s) << " made " << made[s] << " allocations in " << TICKS
+                         << " steady-state ticks (" << run.first << ", " << side << "x" << side << ", density " << density
+                         << ")" << endl;
+                }
+            }
+        }
+    }
+    Logger::categories = savedCategories;
+    if (failures == 0) cout << "Steady-state ticks allocate nothing (" << checks << " stages checked)" << endl;
+    return failures == 0;
 }
 
+// τρεχει το σεναριο για runs διαδοχικα seeds (seed, seed+1, ...) μοιρασμενα στα νηματα του pool,
+// καθε προσομοιωση ολοκληρη σε ενα νημα, και τυπωνει μια συνοψη
+void run_batch(const Scenario& sc, uint64_t seed, int runs, ThreadPool& pool) {
+    vector<SimResult> results(runs);
+    unsigned savedCategories = Logger::categories;
+    Logger::categories = 0;
+    auto start = chrono::steady_clock::now();
+    function<void(int)> runOne = [&](int i) {
+        results[i] = run_simulation(sc, seed + i, nullptr, nullptr, 0);
+    };
+    pool.run(runs, runOne);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    Logger::categories = savedCategories;
+
+    int reached = 0, outOfBounds = 0;
+    long long carsReached = 0;
+    long long totalTicks = 0, expansions = 0, replans = 0, budgetHits = 0;
+    long long collisions = 0, carCollisions = 0;
+    vector<int> ticksToTarget;
+    map<string, long long> decisions;
+    for (const SimResult& r : results) {
+        if (r.reachedAll) {
+            reached++;
+            ticksToTarget.push_back(r.ticksToTarget);
+        }
+        if (r.outOfBounds) outOfBounds++;
+        carsReached += r.carsReached;
+        totalTicks += r.ticks;
+        expansions += r.planner.expansions;
+        replans += r.planner.replans;
+        budgetHits += r.planner.budgetHits;
+        collisions += r.collisions;
+        carCollisions += r.carCollisions;
+        for (const auto& d : r.decisions) decisions[d.first] += d.second;
+    }
+    sort(ticksToTarget.begin(), ticksToTarget.end());
+    auto percentile = [&](double p) {
+        return ticksToTarget[min(ticksToTarget.size() - 1, (size_t)(p * ticksToTarget.size()))];
+    };
+
+    cout << "Batch: " << runs << " runs, seeds " << seed << ".." << seed + runs - 1 << ", " << pool.size()
+         << " threads, " << fixed << setprecision(2) << seconds << " s (" << setprecision(0) << runs / seconds
+         << " runs/s, " << totalTicks / seconds << " ticks/s)" << endl;
+    cout << setprecision(1);
+    cout << "  Reached all targets: " << reached << " (" << 100.0 * reached / runs << "%)" << endl;
+    cout << "  Out of bounds: " << outOfBounds << " (" << 100.0 * outOfBounds / runs << "%)" << endl;
+    if (sc.fleet > 1) {
+        cout << "  Fleet vehicles reaching all targets: " << 100.0 * carsReached / ((double)runs * sc.fleet) << "%" << endl;
+    }
+    if (!ticksToTarget.empty()) {
+        double mean = 0;
+        for (int t : ticksToTarget) mean += t;
+        mean /= ticksToTarget.size();
+        cout << "  Ticks to target: mean " << mean << ", min " << ticksToTarget.front() << ", p50 " << percentile(0.5)
+             << ", p95 " << percentile(0.95) << ", max " << ticksToTarget.back() << endl;
+    }
+    cout << "  Planner per run: " << expansions / (double)runs << " expansions, " << replans / (double)runs
+         << " replans, " << budgetHits / (double)runs << " ticks over budget" << endl;
+    cout << "  Collisions per run: " << collisions / (double)runs << ", " << carCollisions / (double)runs
+         << " with autonomous vehicles" << endl;
+    cout << "  Decisions:" << endl;
+    for (const auto& d : decisions) {
+        cout << "    " << left << setw(12) << d.first << right << setw(12) << d.second
+             << "  (" << 100.0 * d.second / max(1LL, totalTicks) << "%)" << endl;
+    }
+    cout.unsetf(ios::fixed);
+    cout << setprecision(6);
+}
 
 //βοηθητικη συναρτηση για διευκοληνση του χρηστη να καλεσει σωστα το προγραμμα
 void print_help() {
@@ -880,9 +5152,31 @@ void print_help() {
     cout << "--numParkedCars <n>            Number of parked cars (default 7)" << endl;
     cout << "--numStopSigns <n>             Number of signs STOP (default 1)" << endl;
     cout << "--numTrafficLights <n>         Number of traffic lights (default 2)" << endl;
+    cout << "--region <x0 y0 x1 y1 d>       Occupy fraction d of the rectangle's cells, the rest spread outside (repeatable)" << endl;
     cout << "--simulationTicks <n>          Maximum simulation ticks (default 100)" << endl;
     cout << "--minConfidenceThreshold <n>   Minimum confidence threshold (default 40)" << endl;
     cout << "--gps <x1> <y1> [x2 y2  ...]   GPS target coordinates (required)" << endl;
+    cout << "--quiet                        Only print the final result" << endl;
+    cout << "--logLevel <level>             error, warn, info or debug (default debug)" << endl;
+    cout << "--logCategories <list>         Comma list of lifecycle,sensors,fusion,decisions,render,collisions, all or none" << endl;
+    cout << "--threads <n>                  Worker threads for parallel stages (default all cores)" << endl;
+    cout << "--planBudget <n>               Path planner cells expanded per tick at most (default 20000)" << endl;
+    cout << "--fleet <n>                    Autonomous vehicles sharing the world, the rest get random routes (default 1)" << endl;
+    cout << "--saveSnapshot <file>          Save the simulation state to a binary snapshot at the end of the run" << endl;
+    cout << "--snapshotTick <n>             Save the snapshot before tick n instead" << endl;
+    cout << "--loadSnapshot <file>          Continue a saved simulation (replaces the world options and --gps)" << endl;
+    cout << "--recordTrace <file>           Record each tick's readings, fused readings and decision of the vehicle" << endl;
+    cout << "--replayTrace <file>           Rerun the navigation on a recorded trace and compare the decisions" << endl;
+    cout << "--traceTick <n>                With --replayTrace, only show what was recorded at tick n" << endl;
+    cout << "--batch <n>                    Run n simulations (seeds seed..seed+n-1) on all threads, print a summary" << endl;
+    cout << "--sensorRate <n>               Sensors scan every n ticks, tracks are predicted in between (default 1)" << endl;
+    cout << "--live <fps>                   Redraw the whole world in place at fps frames/s (ANSI terminal)" << endl;
+    cout << "--benchLayout <n>              Benchmark a tick over n entities, Object* vs EntityStore" << endl;
+    cout << "--profile <file>               Time each phase of every tick, write a Chrome trace with p50/p95/p99" << endl;
+    cout << "                               (only in a -DPROFILER build, where every phase checks a flag even without it)" << endl;
+    cout << "--benchSuite <file>            Benchmark every stage at several sizes, write JSON to file (- for stdout)" << endl;
+    cout << "--checkAllocs                  Fail if a steady-state tick allocates (needs a -DALLOC_COUNTING build)" << endl;
+    cout << "--benchScan <n>                Benchmark n lidar scans per density, legacy loop vs SIMD kernel, and rays/s" << endl;
     cout << "--help                         Showing this message" << endl;
     cout << "\nUsage:" << endl;
     cout << "./project --seed 12 --dimX 40 --dimY 40 --gps 10 20 30 15" << endl;
@@ -898,8 +5192,28 @@ int main(int argc, char* argv[]) {
     int STOP = 1;
     int TrafficLights = 2;
     int ticks = 100;
-    int seed ;
+    uint64_t seed = (uint64_t)time(nullptr);
     double minConfidenceThreshold = 0.4;
+    int benchEntities = 0;
+    int benchScans = 0;
+    string benchSuitePath;
+    bool checkAllocs = false;
+    string profilePath;
+    int liveFps = 0;
+    int sensorRate = 1;
+    int batchRuns = 0;
+    int planBudget = 20000;
+    int fleet = 1;
+    SnapshotOptions snapshot;
+    string loadPath;
+    string tracePath;
+    string replayPath;
+    int traceTick = -1;
+    bool ticksGiven = false;
+    int threads = max(1, (int)thread::hardware_concurrency());
+
+    // το cout δεν χρειαζεται συγχρονισμο με το stdio, ετσι κραταει δικο του buffer
+    ios::sync_with_stdio(false);
 
     if (argc > 1 && strcmp(argv[1], "--help") == 0) {
         print_help();
@@ -908,12 +5222,11 @@ int main(int argc, char* argv[]) {
 
     int i = 1; 
     vector<Position> destinations;
+    vector<DensityRegion> regions;
     bool gpsProvided = false;
-    bool seedProvided = false;
     while(i < argc) {
         if (strcmp(argv[i], "--seed") == 0 && i+1 < argc) {
-            seed = stoi(argv[i+1]);
-            seedProvided = true;
+            seed = stoull(argv[i+1]);
             i++;
         }
         else if (strcmp(argv[i], "--dimX") == 0 && i+1 < argc) {
@@ -944,14 +5257,109 @@ int main(int argc, char* argv[]) {
             TrafficLights = stoi(argv[i+1]);
             i++;
         }
+        else if (strcmp(argv[i], "--region") == 0 && i+5 < argc) {
+            DensityRegion r;
+            r.x0 = stoi(argv[i+1]);
+            r.y0 = stoi(argv[i+2]);
+            r.x1 = stoi(argv[i+3]);
+            r.y1 = stoi(argv[i+4]);
+            r.density = stod(argv[i+5]);
+            regions.push_back(r);
+            i += 5;
+        }
         else if (strcmp(argv[i], "--simulationTicks") == 0 && i+1 < argc) {
             ticks = stoi(argv[i+1]);
+            ticksGiven = true;
             i++;
         }
         else if (strcmp(argv[i], "--minConfidenceThreshold") == 0 && i+1 < argc) {
             minConfidenceThreshold = stoi(argv[i+1]) / 100.0;
             i++;
         }
+        else if (strcmp(argv[i], "--quiet") == 0) {
+            Logger::level = LogLevel::Error;
+        }
+        else if (strcmp(argv[i], "--logLevel") == 0 && i+1 < argc) {
+            if (!Logger::parseLevel(argv[i+1])) {
+                cout << "ERROR: Unknown log level " << argv[i+1] << endl;
+                return 1;
+            }
+            i++;
+        }
+        else if (strcmp(argv[i], "--logCategories") == 0 && i+1 < argc) {
+            if (!Logger::parseCategories(argv[i+1])) {
+                cout << "ERROR: Unknown log category in " << argv[i+1] << endl;
+                return 1;
+            }
+            i++;
+        }
+        else if (strcmp(argv[i], "--threads") == 0 && i+1 < argc) {
+            threads = max(1, stoi(argv[i+1]));
+            i++;
+        }
+        else if (strcmp(argv[i], "--planBudget") == 0 && i+1 < argc) {
+            planBudget = max(1, stoi(argv[i+1]));
+            i++;
+        }
+        else if (strcmp(argv[i], "--fleet") == 0 && i+1 < argc) {
+            fleet = max(1, stoi(argv[i+1]));
+            i++;
+        }
+        else if (strcmp(argv[i], "--saveSnapshot") == 0 && i+1 < argc) {
+            snapshot.savePath = argv[i+1];
+            i++;
+        }
+        else if (strcmp(argv[i], "--snapshotTick") == 0 && i+1 < argc) {
+            snapshot.saveTick = stoi(argv[i+1]);
+            i++;
+        }
+        else if (strcmp(argv[i], "--loadSnapshot") == 0 && i+1 < argc) {
+            loadPath = argv[i+1];
+            i++;
+        }
+        else if (strcmp(argv[i], "--recordTrace") == 0 && i+1 < argc) {
+            tracePath = argv[i+1];
+            i++;
+        }
+        else if (strcmp(argv[i], "--replayTrace") == 0 && i+1 < argc) {
+            replayPath = argv[i+1];
+            i++;
+        }
+        else if (strcmp(argv[i], "--traceTick") == 0 && i+1 < argc) {
+            traceTick = stoi(argv[i+1]);
+            i++;
+        }
+        else if (strcmp(argv[i], "--batch") == 0 && i+1 < argc) {
+            batchRuns = stoi(argv[i+1]);
+            i++;
+        }
+        else if (strcmp(argv[i], "--sensorRate") == 0 && i+1 < argc) {
+            sensorRate = max(1, stoi(argv[i+1]));
+            i++;
+        }
+        else if (strcmp(argv[i], "--live") == 0 && i+1 < argc) {
+            liveFps = max(1, stoi(argv[i+1]));
+            i++;
+        }
+        else if (strcmp(argv[i], "--benchLayout") == 0 && i+1 < argc) {
+            benchEntities = stoi(argv[i+1]);
+            i++;
+        }
+        else if (strcmp(argv[i], "--profile") == 0 && i+1 < argc) {
+            profilePath = argv[i+1];
+            i++;
+        }
+        else if (strcmp(argv[i], "--benchSuite") == 0 && i+1 < argc) {
+            benchSuitePath = argv[i+1];
+            i++;
+        }
+        else if (strcmp(argv[i], "--checkAllocs") == 0) {
+            checkAllocs = true;
+        }
+        else if (strcmp(argv[i], "--benchScan") == 0 && i+1 < argc) {
+            benchScans = stoi(argv[i+1]);
+            i++;
+        }
         else if (strcmp(argv[i], "--gps") == 0 && i+1 < argc) {
             // περνω τις συντεταγμενες gps που μου δινει ο χρηστης κατα την κληση του προγραμματος
             //για την θεση του αυτοκινουμενου οχηματος αλλα και για τον(-ους) στοχο(-ους)
@@ -970,163 +5378,131 @@ int main(int argc, char* argv[]) {
         i++;
     }
 
-    if (!gpsProvided) {
-        cout << "ERROR: GPS coordinates required!" << endl;
-        cout << "Use --gps <x1> <y1> [x2 y2 ...]" << endl;
-        cout << "Try --help for usage information" << endl;
-        return 1;
-    }
-    
-    if (destinations.empty()) {
-        cout << "ERROR: At least one GPS coordinate required!" << endl;
-        return 1;
-    }
-    
-    // ελεγχω ασν εχει δωθει απο τον χρηστη τιμη seed αν δεν εχει με την βοηθεια της srand περναω μια τυχαια τιμη στην μεταβλητη seed 
-    if(seedProvided){
-        srand(seed); 
+    if (benchEntities > 0) {
+        bench_layout(benchEntities);
+        return 0;
     }
 
-    // δημιουργω τον κοσμο 
-    GridWorld world(dimX, dimY);
-    
-    // δημιουργω το αυτοκινουμενο οχημα με της συντεταγμενες που εδωσε ο χρηστης
-    SelfDrivingCar car;
-    car.setPosition(destinations[0].x, destinations[0].y);
-    
-    // αν υπαρχουν παραπανω απο ενας στοχος τους περναω σε vector
-    if (destinations.size() > 1) {
-        vector<Position> remainingTargets(destinations.begin() + 1, destinations.end());
-        car.setNavigationTargets(remainingTargets);
-    } 
-    else {
-        //αλλιως εχω ηδη φτασει στοιν τελικο προορισμο και τερματιζω το προγραμμα αφου κανω εκτυπωση της τελικης καταστασης
-        visualization_full(world, car);
+    if (benchScans > 0) {
+        bench_scan(benchScans);
         return 0;
     }
-    
-    vector<string> directions = {"N", "S", "E", "W"};
-    
-    // προσθετω στον κοσμο τα ποδηλατα
-    for (int i = 0; i < MovingBikes; i++) {
-        Position pos(rand() % dimX, rand() % dimY);
-        // Ensure not on car position
-        while (pos.x == car.getPosition().x && pos.y == car.getPosition().y) {
-            pos = Position(rand() % dimX, rand() % dimY);
-        }
-        world.addObject(new Bike(pos));
-    }
-    
-    // προσθετω στον κοσμο τα υπολοιπα κινουμενα αυτοκινητα
-    for (int i = 0; i < MovingCars; i++) {
-        Position pos(rand() % dimX, rand() % dimY);
-        while (pos.x == car.getPosition().x && pos.y == car.getPosition().y) {
-            pos = Position(rand() % dimX, rand() % dimY);
-        }
-        world.addObject(new OtherCar(pos));
-    }
-    
-    // προσθετω στον κοσμο τα παρκαριμενα αυτοκινητα
-    for (int i = 0; i < ParkedCars; i++) {
-        Position pos(rand() % dimX, rand() % dimY);
-        while (pos.x == car.getPosition().x && pos.y == car.getPosition().y) {
-            pos = Position(rand() % dimX, rand() % dimY);
-        }
-        world.addObject(new ParkedCar(pos));
+
+    if (!benchSuitePath.empty()) {
+        return bench_suite(benchSuitePath) ? 0 : 1;
     }
-    
-    // προσθετω στον κοσμο τα σηματα STOP
-    for (int i = 0; i < STOP; i++) {
-        Position pos(rand() % dimX, rand() % dimY);
-        while (pos.x == car.getPosition().x && pos.y == car.getPosition().y) {
-            pos = Position(rand() % dimX, rand() % dimY);
-        }
-        world.addObject(new StopSign(pos));
+
+    if (checkAllocs) {
+        return check_allocs() ? 0 : 1;
     }
-    
-    // προσθετω στιν κοσμο τα φαναρια
-    for (int i = 0; i < TrafficLights; i++) {
-        Position pos(rand() % dimX, rand() % dimY);
-        while (pos.x == car.getPosition().x && pos.y == car.getPosition().y) {
-            pos = Position(rand() % dimX, rand() % dimY);
+
+    // το replay δεν χρειαζεται κοσμο, ολα ειναι στο trace
+    if (!replayPath.empty()) {
+        TraceReader trace;
+        if (!trace.open(replayPath)) {
+            cout << "ERROR: Cannot read trace " << replayPath << endl;
+            return 1;
         }
-        world.addObject(new TrafficLight(pos));
+        bool ok = traceTick >= 0 ? show_trace_tick(trace, traceTick) : replay_trace(trace);
+        return ok ? 0 : 1;
     }
-    
-    // εκτυπωνωψ την πληρη εικονα του κοσμου με την συναρτηση visualization_full
-    visualization_full(world, car);
-    
-    bool simulationRunning = true;
-    bool carRunning = true;
-    
-    for (int tick = 0; tick < ticks && simulationRunning && carRunning; tick++) {
-        
-        // ενημερωση των αντικειμενων του κοσμου 
-        world.updateAll(tick);
-        
-        vector<Object*> objects = world.getObjects();
-        for (auto obj : objects) {
-            if (Bike* bike = dynamic_cast<Bike*>(obj)) {
-                if (!bike->move(world)) {
-                    world.removeObject(obj);
-                }
-            } else if (OtherCar* otherCar = dynamic_cast<OtherCar*>(obj)) {
-                if (!otherCar->move(world)) {
-                    world.removeObject(obj);
-                }
-            }
-        }
-        
-        // εδω το αμαξι εκτελει τις βασικες του λειτουργιες(συλεγει πληροφοριες απο τους αισθητηρες και ενεργοποιει το σθστημα πλοηγησης)
-        car.collectSensorData(world);
-        car.syncNavigationSystem();
-        
-        //εμφανιζω τα στοιχεια των αιθητηρων
-        const vector<SensorReading>& readings = car.getLastReadings();
-        if (readings.empty()) {
-            cout << "  No objects detected" << endl;
-        } else {
-            for (const auto& reading : readings) {
-                reading.print();
-            }
+
+    Scenario scenario;
+    // απο snapshot: ο κοσμος, το σεναριο και το seed ειναι του αρχειου, μονο το --simulationTicks μετραει
+    Snapshot resume;
+    if (!loadPath.empty()) {
+        if (!resume.open(loadPath)) {
+            cout << "ERROR: Cannot load snapshot " << loadPath << endl;
+            return 1;
         }
-        
-        cout << "\nFused Sensor Readings:" << endl;
-        const vector<SensorReading>& fused = car.getFusedReadings();
-        if (fused.empty()) {
-            cout << "  No fused readings" << endl;
-        } else {
-            for (const auto& reading : fused) {
-                reading.print();
-            }
+        scenario = resume.scenario();
+        if (!check_scenario(scenario)) return 1;
+        if (ticksGiven) scenario.ticks = ticks;
+        seed = resume.seed();
+        snapshot.resume = &resume;
+        batchRuns = 0;
+    } else {
+        if (!gpsProvided) {
+            cout << "ERROR: GPS coordinates required!" << endl;
+            cout << "Use --gps <x1> <y1> [x2 y2 ...]" << endl;
+            cout << "Try --help for usage information" << endl;
+            return 1;
         }
         
-        //το αμαξι εδω εκτελει τις κινησεις για να κατευθηνθει προς τον στοχο
-        carRunning = car.executeMovement(world);
-        
-        // ελεγχω αν το αμαξι ειναι εκτος οριων 
-        if (!world.inBounds(car.getPosition().x, car.getPosition().y)) {
-            cout << "\n!!! CAR WENT OUT OF BOUNDS !!!" << endl;
-            simulationRunning = false;
-            break;
+        if (destinations.empty()) {
+            cout << "ERROR: At least one GPS coordinate required!" << endl;
+            return 1;
         }
         
-        // εμφανιζω το κομματι του κοσμου που ειναι γυρο απο το οχημα
-        if (tick % 10 == 0 || tick == ticks - 1) {
-            visualization_pov(world, car, 5);
+        // ολες οι τυχαιες ροες βγαινουν απο το seed (αν δεν δοθει, η τρεχουσα ωρα)
+        scenario.dimX = dimX;
+        scenario.dimY = dimY;
+        scenario.movingCars = MovingCars;
+        scenario.movingBikes = MovingBikes;
+        scenario.parkedCars = ParkedCars;
+        scenario.stopSigns = STOP;
+        scenario.trafficLights = TrafficLights;
+        scenario.ticks = ticks;
+        scenario.minConfidenceThreshold = minConfidenceThreshold;
+        scenario.sensorRate = sensorRate;
+        scenario.planBudget = planBudget;
+        scenario.fleet = fleet;
+        scenario.destinations = destinations;
+        scenario.regions = regions;
+        if (!check_scenario(scenario)) return 1;
+    }
+
+    if (batchRuns > 0) {
+        ThreadPool pool(threads);
+        run_batch(scenario, seed, batchRuns, pool);
+        return 0;
+    }
+
+    // στο live mode η οθονη ανηκει στον renderer, τα υπολοιπα μηνυματα τα κλεινω
+    if (liveFps > 0) Logger::categories = 0;
+
+    // ο profiler καταγραφει μονο τη μια προσομοιωση, οχι το batch
+    if (!profilePath.empty()) {
+#ifdef PROFILER
+        Profiler::start();
+#else
+        cout << "WARNING: built without -DPROFILER, --profile ignored" << endl;
+        profilePath.clear();
+#endif
+    }
+
+    TraceWriter trace;
+    if (!tracePath.empty() && !trace.open(tracePath, scenario, seed)) {
+        cout << "ERROR: Cannot write trace to " << tracePath << endl;
+        return 1;
+    }
+
+    FrameRenderer renderer;
+    // ενα νημα για καθε αισθητηρα το πολυ, ή με στολο ολα τα νηματα για τα οχηματα. ολα τα νηματα και
+    // για μεγαλους κοσμους, τους στηνουν παραλληλα. τα νηματα μενουν ζωντανα για ολη την προσομοιωση
+    bool largeWorld = scenario.entities() >= (1 << 20);
+    ThreadPool sensorPool(scenario.fleet > 1 || largeWorld ? threads : min(threads, 3));
+    SimResult result = run_simulation(scenario, seed, sensorPool.size() > 1 ? &sensorPool : nullptr, &renderer, liveFps,
+                                      &snapshot, tracePath.empty() ? nullptr : &trace);
+    if (result.damagedSnapshot) return 1;
+
+    if (!tracePath.empty()) {
+        if (!trace.finish()) {
+            cout << "ERROR: Cannot write trace to " << tracePath << endl;
+            return 1;
         }
+        cout << "Trace of " << trace.ticks() << " ticks written to " << tracePath << endl;
     }
-    
-    // εκτυπωνων προς τον χρηστη την τελικη θεση του αυτονομου αυτοκινητου στον κοσμο
-    cout << "Final Position: (" << car.getPosition().x << "," << car.getPosition().y << ")" << endl;
-    
-    if (car.get_navigation().hasMoreTargets()) {
-        cout << "Remaining targets: Yes" << endl;
-    } else {
-        cout << "All targets reached!" << endl;
+
+    if (!profilePath.empty()) {
+        Profiler::enabled = false;
+        if (!Profiler::writeTrace(profilePath)) {
+            cout << "ERROR: Cannot write profile to " << profilePath << endl;
+            return 1;
+        }
+        Profiler::printSummary(cout);
+        cout << "Profile written to " << profilePath << endl;
     }
     
-    visualization_full(world, car);
-    
     return 0;
-}
\ No newline at end of file
+}